@@ -1,5 +1,8 @@
 #include <Arduino.h>
 #include <Adafruit_NeoPixel.h>
+#ifdef __AVR__
+#include <avr/sleep.h>
+#endif
 
 // NeoPixel configuration
 #define LED_PIN 6
@@ -18,8 +21,39 @@
 #define POT_MIN 15    // Typical low-end value (instead of 0)
 #define POT_MAX 1000  // Typical high-end value (instead of 1023)
 
+// Potentiometer hysteresis (ADC counts the smoothed value must move before it
+// counts as a change) and how often the pots and button are polled
+#define POT_HYSTERESIS 4
+#define POT_SMOOTHING_SHIFT 3 // Moving average over about 2^3 readings
+#define INPUT_POLL_INTERVAL 20
+
+// Input change events returned by pollInputs()
+#define EVENT_BRIGHTNESS 0x01
+#define EVENT_HUE 0x02
+#define EVENT_SPEED 0x04
+#define EVENT_BUTTON 0x08
+
+// Frame delay returned by effects that only change when an input changes.
+// Static effects are redrawn on input events and every STATIC_REFRESH_MS.
+#define FRAME_STATIC 0
+#define STATIC_REFRESH_MS 1000
+
+// Microphone configuration (analog output module, e.g. MAX4466 or MAX9814)
+#define MIC_PIN A3
+
+// Sound spectrum analyzer: blocks of AUDIO_SAMPLES readings at about 9615 Hz
+// (free-running ADC, prescaler 128), analyzed with a fixed-point real FFT
+// computed as a complex FFT of half the length
+#define AUDIO_SAMPLES 128
+#define AUDIO_SAMPLES_LOG2 7
+#define AUDIO_FFT_POINTS (AUDIO_SAMPLES / 2)
+#define AUDIO_SAMPLE_PERIOD_US 104
+#define AUDIO_BANDS 8
+#define AUDIO_NOISE_FLOOR 32     // Band magnitudes at or below this show as off
+#define AUDIO_FRAME_INTERVAL 10  // ms between frames, on top of the 13.3 ms capture and the analysis
+
 // Number of effects available
-#define NUM_EFFECTS 8
+#define NUM_EFFECTS 9
 
 Adafruit_NeoPixel strip(LED_COUNT, LED_PIN, NEO_GRB + NEO_KHZ800);
 
@@ -29,157 +63,817 @@ bool lastButtonState = HIGH;
 unsigned long lastDebounceTime = 0;
 unsigned long debounceDelay = 50;
 
-// --- Helper: read brightness knob and convert to brightness (0..255) ---
-uint8_t readBrightnessFromPot()
+// --- Rainbow color wheel (one full hue cycle, precomputed) ---
+// 256 steps of ColorHSV(step * 256, 255, 255) with gamma correction (2.6)
+// already applied, stored in flash so rainbows are a table lookup per pixel
+// (plus an 8-bit interpolation between neighbouring steps)
+const uint8_t RAINBOW_WHEEL[256][3] PROGMEM = {
+    {255, 0, 0}, {255, 0, 0}, {255, 0, 0}, {255, 0, 0}, {255, 1, 0}, {255, 1, 0}, {255, 2, 0}, {255, 2, 0},
+    {255, 3, 0}, {255, 5, 0}, {255, 6, 0}, {255, 8, 0}, {255, 10, 0}, {255, 12, 0}, {255, 14, 0}, {255, 17, 0},
+    {255, 20, 0}, {255, 24, 0}, {255, 27, 0}, {255, 31, 0}, {255, 36, 0}, {255, 41, 0}, {255, 45, 0}, {255, 51, 0},
+    {255, 57, 0}, {255, 63, 0}, {255, 70, 0}, {255, 77, 0}, {255, 85, 0}, {255, 93, 0}, {255, 102, 0}, {255, 111, 0},
+    {255, 120, 0}, {255, 130, 0}, {255, 141, 0}, {255, 152, 0}, {255, 164, 0}, {255, 176, 0}, {255, 188, 0}, {255, 202, 0},
+    {255, 215, 0}, {255, 230, 0}, {255, 245, 0}, {250, 255, 0}, {235, 255, 0}, {220, 255, 0}, {206, 255, 0}, {193, 255, 0},
+    {180, 255, 0}, {168, 255, 0}, {156, 255, 0}, {145, 255, 0}, {134, 255, 0}, {124, 255, 0}, {114, 255, 0}, {105, 255, 0},
+    {96, 255, 0}, {88, 255, 0}, {80, 255, 0}, {72, 255, 0}, {65, 255, 0}, {59, 255, 0}, {53, 255, 0}, {47, 255, 0},
+    {42, 255, 0}, {38, 255, 0}, {33, 255, 0}, {29, 255, 0}, {25, 255, 0}, {21, 255, 0}, {18, 255, 0}, {15, 255, 0},
+    {13, 255, 0}, {10, 255, 0}, {8, 255, 0}, {6, 255, 0}, {5, 255, 0}, {4, 255, 0}, {3, 255, 0}, {2, 255, 0},
+    {1, 255, 0}, {1, 255, 0}, {0, 255, 0}, {0, 255, 0}, {0, 255, 0}, {0, 255, 0}, {0, 255, 0}, {0, 255, 0},
+    {0, 255, 0}, {0, 255, 0}, {0, 255, 1}, {0, 255, 1}, {0, 255, 2}, {0, 255, 3}, {0, 255, 4}, {0, 255, 5},
+    {0, 255, 7}, {0, 255, 9}, {0, 255, 11}, {0, 255, 13}, {0, 255, 16}, {0, 255, 19}, {0, 255, 22}, {0, 255, 26},
+    {0, 255, 30}, {0, 255, 34}, {0, 255, 39}, {0, 255, 43}, {0, 255, 49}, {0, 255, 55}, {0, 255, 61}, {0, 255, 68},
+    {0, 255, 75}, {0, 255, 82}, {0, 255, 90}, {0, 255, 99}, {0, 255, 108}, {0, 255, 117}, {0, 255, 127}, {0, 255, 137},
+    {0, 255, 148}, {0, 255, 160}, {0, 255, 172}, {0, 255, 184}, {0, 255, 197}, {0, 255, 211}, {0, 255, 225}, {0, 255, 240},
+    {0, 255, 255}, {0, 240, 255}, {0, 225, 255}, {0, 211, 255}, {0, 197, 255}, {0, 184, 255}, {0, 172, 255}, {0, 160, 255},
+    {0, 148, 255}, {0, 137, 255}, {0, 127, 255}, {0, 117, 255}, {0, 108, 255}, {0, 99, 255}, {0, 90, 255}, {0, 82, 255},
+    {0, 75, 255}, {0, 68, 255}, {0, 61, 255}, {0, 55, 255}, {0, 49, 255}, {0, 43, 255}, {0, 39, 255}, {0, 34, 255},
+    {0, 30, 255}, {0, 26, 255}, {0, 22, 255}, {0, 19, 255}, {0, 16, 255}, {0, 13, 255}, {0, 11, 255}, {0, 9, 255},
+    {0, 7, 255}, {0, 5, 255}, {0, 4, 255}, {0, 3, 255}, {0, 2, 255}, {0, 1, 255}, {0, 1, 255}, {0, 0, 255},
+    {0, 0, 255}, {0, 0, 255}, {0, 0, 255}, {0, 0, 255}, {0, 0, 255}, {0, 0, 255}, {0, 0, 255}, {1, 0, 255},
+    {1, 0, 255}, {2, 0, 255}, {3, 0, 255}, {4, 0, 255}, {5, 0, 255}, {6, 0, 255}, {8, 0, 255}, {10, 0, 255},
+    {13, 0, 255}, {15, 0, 255}, {18, 0, 255}, {21, 0, 255}, {25, 0, 255}, {29, 0, 255}, {33, 0, 255}, {38, 0, 255},
+    {42, 0, 255}, {47, 0, 255}, {53, 0, 255}, {59, 0, 255}, {65, 0, 255}, {72, 0, 255}, {80, 0, 255}, {88, 0, 255},
+    {96, 0, 255}, {105, 0, 255}, {114, 0, 255}, {124, 0, 255}, {134, 0, 255}, {145, 0, 255}, {156, 0, 255}, {168, 0, 255},
+    {180, 0, 255}, {193, 0, 255}, {206, 0, 255}, {220, 0, 255}, {235, 0, 255}, {250, 0, 255}, {255, 0, 245}, {255, 0, 230},
+    {255, 0, 215}, {255, 0, 202}, {255, 0, 188}, {255, 0, 176}, {255, 0, 164}, {255, 0, 152}, {255, 0, 141}, {255, 0, 130},
+    {255, 0, 120}, {255, 0, 111}, {255, 0, 102}, {255, 0, 93}, {255, 0, 85}, {255, 0, 77}, {255, 0, 70}, {255, 0, 63},
+    {255, 0, 57}, {255, 0, 51}, {255, 0, 45}, {255, 0, 41}, {255, 0, 36}, {255, 0, 31}, {255, 0, 27}, {255, 0, 24},
+    {255, 0, 20}, {255, 0, 17}, {255, 0, 14}, {255, 0, 12}, {255, 0, 10}, {255, 0, 8}, {255, 0, 6}, {255, 0, 5},
+    {255, 0, 3}, {255, 0, 2}, {255, 0, 2}, {255, 0, 1}, {255, 0, 1}, {255, 0, 0}, {255, 0, 0}, {255, 0, 0},
+};
+
+// Gamma-corrected color for a 16-bit hue, interpolated between the two
+// nearest wheel steps so every hue change (and every pixel) is distinct
+uint32_t rainbowWheelColor(uint16_t hue)
 {
-  // Multiple dummy reads to fully settle ADC when switching pins
-  for (int i = 0; i < 3; i++)
+  uint8_t step = hue >> 8;
+  uint8_t next = step + 1; // Wraps from the last step back to red
+  uint8_t frac = hue & 0xFF;
+
+  uint8_t rgb[3];
+  for (uint8_t c = 0; c < 3; c++)
   {
-    analogRead(POT_PIN_BRIGHTNESS);
+    uint8_t from = pgm_read_byte(&RAINBOW_WHEEL[step][c]);
+    uint8_t to = pgm_read_byte(&RAINBOW_WHEEL[next][c]);
+    rgb[c] = from + ((((int16_t)to - from) * frac) >> 8);
   }
-  delayMicroseconds(100);
 
-  // Read raw pot value (0..1023)
-  int raw = analogRead(POT_PIN_BRIGHTNESS);
+  return strip.Color(rgb[0], rgb[1], rgb[2]);
+}
 
-  // Simple smoothing (exponential moving average)
-  static int filtered = 512; // Start at mid brightness
-  filtered = (filtered * 7 + raw) / 8;
+// --- Color temperature engine (tunable white) ---
+// Calibration points from warmest to coolest. The warmth pot spreads them
+// evenly over its range: add, remove or retune points to match your strip.
+// Kelvin values are approximate and must increase from point to point.
+// Stored in flash: read it at runtime with whitePointRead().
+struct WhitePoint
+{
+  uint16_t kelvin;
+  uint8_t r, g, b;
+};
+
+constexpr WhitePoint WHITE_POINTS[] PROGMEM = {
+    {1900, 255, 147, 41},   // Very warm candlelight
+    {2300, 255, 169, 87},   // Warm amber
+    {2600, 255, 197, 143},  // Warm
+    {2850, 255, 214, 170},  // Soft warm
+    {3200, 255, 241, 224},  // Warm white
+    {7000, 245, 243, 255},  // Slightly cool
+    {8000, 225, 235, 255},  // Cool
+    {10000, 201, 226, 255}, // Very cool daylight
+};
+
+#define WHITE_POINT_COUNT (sizeof(WHITE_POINTS) / sizeof(WHITE_POINTS[0]))
+#define WARMTH_MAX 1023
+#define WARMTH_TABLE_SHIFT 4 // 16 warmth steps between table entries
+
+// Warmth (0..WARMTH_MAX) at which calibration point i sits
+constexpr long whitePointWarmth(uint8_t i)
+{
+  return (2L * i * WARMTH_MAX + WHITE_POINT_COUNT - 1) / (2L * (WHITE_POINT_COUNT - 1));
+}
 
-  // Map actual pot range to 0..255 (NeoPixel brightness is 8-bit)
-  uint8_t brightness = map(filtered, POT_MIN, POT_MAX, 0, 255);
-  brightness = constrain(brightness, 0, 255); // Ensure we stay within bounds
-  return brightness;
+// Calibration segment containing warmth (index of the point at or below it)
+constexpr uint8_t whiteSegment(long warmth, uint8_t i = 0)
+{
+  return (i + 2 >= (int)WHITE_POINT_COUNT || warmth < whitePointWarmth(i + 1)) ? i : whiteSegment(warmth, i + 1);
 }
 
-// --- Helper: read knob and convert to hue (0..65535) ---
-uint16_t readHueFromPot()
+// Calibration value of point i: channel 0..2 is R, G, B and 3 is Kelvin
+constexpr long whitePointValue(uint8_t i, uint8_t channel)
 {
-  // Multiple dummy reads to fully settle ADC when switching pins
-  for (int i = 0; i < 3; i++)
+  return channel == 0 ? WHITE_POINTS[i].r : channel == 1 ? WHITE_POINTS[i].g : channel == 2 ? WHITE_POINTS[i].b : WHITE_POINTS[i].kelvin;
+}
+
+// Linear interpolation between the two points around warmth, same as map()
+constexpr long whiteSegmentValue(long warmth, uint8_t seg, uint8_t channel)
+{
+  return whitePointValue(seg, channel) + (whitePointValue(seg + 1, channel) - whitePointValue(seg, channel)) *
+                                             (warmth - whitePointWarmth(seg)) /
+                                             (whitePointWarmth(seg + 1) - whitePointWarmth(seg));
+}
+
+// Warmth position of table entry j. The last entry sits one table step past
+// the second to last (beyond WARMTH_MAX), extending the coolest segment, so
+// every gap interpolates over exactly 1 << WARMTH_TABLE_SHIFT steps.
+constexpr long warmthEntryPosition(uint8_t j)
+{
+  return (long)j << WARMTH_TABLE_SHIFT;
+}
+
+constexpr uint8_t clampChannel(long value)
+{
+  return value < 0 ? 0 : value > 255 ? 255 : value;
+}
+
+constexpr uint8_t warmthEntryValue(uint8_t j, uint8_t channel)
+{
+  return clampChannel(whiteSegmentValue(warmthEntryPosition(j), whiteSegment(warmthEntryPosition(j)), channel));
+}
+
+constexpr bool whitePointsAscending(uint8_t i = 1)
+{
+  return i >= WHITE_POINT_COUNT || (WHITE_POINTS[i - 1].kelvin < WHITE_POINTS[i].kelvin && whitePointsAscending(i + 1));
+}
+
+static_assert(WHITE_POINT_COUNT >= 2, "WHITE_POINTS needs at least 2 calibration points");
+static_assert(whitePointsAscending(), "WHITE_POINTS must go from warm (low Kelvin) to cool (high Kelvin)");
+
+// Warmth -> RGB table, generated at compile time from WHITE_POINTS and stored
+// in flash: one entry per 16 warmth steps, plus one extra so the last step can
+// interpolate towards WARMTH_MAX
+#define WARMTH_TABLE_SIZE ((WARMTH_MAX >> WARMTH_TABLE_SHIFT) + 2)
+#define WARMTH_RGB(j) {warmthEntryValue(j, 0), warmthEntryValue(j, 1), warmthEntryValue(j, 2)}
+
+const uint8_t WARMTH_RGB_TABLE[WARMTH_TABLE_SIZE][3] PROGMEM = {
+    WARMTH_RGB(0), WARMTH_RGB(1), WARMTH_RGB(2), WARMTH_RGB(3), WARMTH_RGB(4), WARMTH_RGB(5), WARMTH_RGB(6), WARMTH_RGB(7),
+    WARMTH_RGB(8), WARMTH_RGB(9), WARMTH_RGB(10), WARMTH_RGB(11), WARMTH_RGB(12), WARMTH_RGB(13), WARMTH_RGB(14), WARMTH_RGB(15),
+    WARMTH_RGB(16), WARMTH_RGB(17), WARMTH_RGB(18), WARMTH_RGB(19), WARMTH_RGB(20), WARMTH_RGB(21), WARMTH_RGB(22), WARMTH_RGB(23),
+    WARMTH_RGB(24), WARMTH_RGB(25), WARMTH_RGB(26), WARMTH_RGB(27), WARMTH_RGB(28), WARMTH_RGB(29), WARMTH_RGB(30), WARMTH_RGB(31),
+    WARMTH_RGB(32), WARMTH_RGB(33), WARMTH_RGB(34), WARMTH_RGB(35), WARMTH_RGB(36), WARMTH_RGB(37), WARMTH_RGB(38), WARMTH_RGB(39),
+    WARMTH_RGB(40), WARMTH_RGB(41), WARMTH_RGB(42), WARMTH_RGB(43), WARMTH_RGB(44), WARMTH_RGB(45), WARMTH_RGB(46), WARMTH_RGB(47),
+    WARMTH_RGB(48), WARMTH_RGB(49), WARMTH_RGB(50), WARMTH_RGB(51), WARMTH_RGB(52), WARMTH_RGB(53), WARMTH_RGB(54), WARMTH_RGB(55),
+    WARMTH_RGB(56), WARMTH_RGB(57), WARMTH_RGB(58), WARMTH_RGB(59), WARMTH_RGB(60), WARMTH_RGB(61), WARMTH_RGB(62), WARMTH_RGB(63),
+    WARMTH_RGB(64),
+};
+
+static_assert(WARMTH_TABLE_SIZE == 65, "Update the table initialiser when changing WARMTH_TABLE_SHIFT");
+
+// Interpolated white for a warmth position (0 = warmest, WARMTH_MAX = coolest)
+uint32_t whiteFromWarmth(uint16_t warmth)
+{
+  warmth = min(warmth, WARMTH_MAX);
+  uint8_t index = warmth >> WARMTH_TABLE_SHIFT;
+  uint8_t frac = warmth & ((1 << WARMTH_TABLE_SHIFT) - 1);
+
+  uint8_t rgb[3];
+  for (uint8_t c = 0; c < 3; c++)
   {
-    analogRead(POT_PIN_HUE);
+    uint8_t from = pgm_read_byte(&WARMTH_RGB_TABLE[index][c]);
+    uint8_t to = pgm_read_byte(&WARMTH_RGB_TABLE[index + 1][c]);
+    rgb[c] = from + ((((int16_t)to - from) * frac) >> WARMTH_TABLE_SHIFT);
   }
-  delayMicroseconds(100);
 
-  // Read raw pot value (0..1023)
-  int raw = analogRead(POT_PIN_HUE);
+  return strip.Color(rgb[0], rgb[1], rgb[2]);
+}
 
-  // Simple smoothing (exponential moving average)
-  static int filtered = 0;
-  filtered = (filtered * 7 + raw) / 8;
+// Calibration value of point i read from flash at runtime: channel 0..2 is
+// R, G, B and 3 is Kelvin, as in whitePointValue()
+long whitePointRead(uint8_t i, uint8_t channel)
+{
+  if (channel == 3)
+  {
+    return pgm_read_word(&WHITE_POINTS[i].kelvin);
+  }
+  return pgm_read_byte(&WHITE_POINTS[i].r + channel);
+}
 
-  // Map actual pot range to 0..65535 (NeoPixel HSV hue is 16-bit)
-  uint32_t hue = map(filtered, POT_MIN, POT_MAX, 0, 65535);
-  hue = constrain(hue, 0, 65535); // Ensure we stay within bounds
-  return (uint16_t)hue;
+// Calibration segment containing a Kelvin value (index of the point at or below it)
+uint8_t kelvinSegment(uint16_t kelvin)
+{
+  uint8_t seg = 0;
+  while (seg + 2 < (int)WHITE_POINT_COUNT && kelvin >= whitePointRead(seg + 1, 3))
+  {
+    seg++;
+  }
+  return seg;
 }
 
-// --- Helper: read speed knob and convert to delay time (10..1000ms) ---
-uint16_t readSpeedFromPot()
+// Clamp a Kelvin value to the calibrated range
+uint16_t constrainKelvin(uint16_t kelvin)
+{
+  long warmest = whitePointRead(0, 3);
+  long coolest = whitePointRead(WHITE_POINT_COUNT - 1, 3);
+  return constrain((long)kelvin, warmest, coolest);
+}
+
+// Approximate color temperature (Kelvin) of a warmth position. Kelvin and
+// warmth are both linear between calibration points, so this (and the two
+// functions below) interpolate the points directly instead of the table.
+uint16_t warmthToKelvin(uint16_t warmth)
+{
+  warmth = min(warmth, WARMTH_MAX);
+  uint8_t seg = whiteSegment(warmth);
+  return map(warmth, whitePointWarmth(seg), whitePointWarmth(seg + 1), whitePointRead(seg, 3),
+             whitePointRead(seg + 1, 3));
+}
+
+// Warmth position for a color temperature, clamped to the calibrated range
+uint16_t kelvinToWarmth(uint16_t kelvin)
+{
+  kelvin = constrainKelvin(kelvin);
+  uint8_t seg = kelvinSegment(kelvin);
+  return map(kelvin, whitePointRead(seg, 3), whitePointRead(seg + 1, 3), whitePointWarmth(seg),
+             whitePointWarmth(seg + 1));
+}
+
+// Interpolated white for a color temperature in Kelvin (exact at every
+// calibration point)
+uint32_t whiteFromKelvin(uint16_t kelvin)
+{
+  kelvin = constrainKelvin(kelvin);
+  uint8_t seg = kelvinSegment(kelvin);
+  long from = whitePointRead(seg, 3);
+  long to = whitePointRead(seg + 1, 3);
+
+  uint8_t rgb[3];
+  for (uint8_t c = 0; c < 3; c++)
+  {
+    rgb[c] = map(kelvin, from, to, whitePointRead(seg, c), whitePointRead(seg + 1, c));
+  }
+
+  return strip.Color(rgb[0], rgb[1], rgb[2]);
+}
+
+// --- Per-pixel kernels, specialised on strip length at compile time ---
+// Narrowest unsigned type that can index every pixel (8-bit up to 255 LEDs)
+template <bool FitsInByte>
+struct PixelIndex
+{
+  typedef uint16_t type;
+};
+
+template <>
+struct PixelIndex<true>
+{
+  typedef uint8_t type;
+};
+
+template <uint16_t Count>
+struct StripKernel
+{
+  static_assert(Count >= 2, "Gradient kernels need at least 2 LEDs");
+
+  typedef typename PixelIndex<(Count <= 255)>::type index_t;
+
+  // Hue offset between neighbouring pixels for a rainbow spanning the strip
+  static const uint16_t HUE_STEP = 65536UL / Count;
+
+  // Fire gradient: first pixel of the middle (>= 33%) and top (>= 66%) thirds
+  static const index_t FIRE_MIDDLE_START = (33UL * (Count - 1) + 99) / 100;
+  static const index_t FIRE_TOP_START = (66UL * (Count - 1) + 99) / 100;
+
+  // Blend factor (Q15, 32768 = 1.0) at the start of each third and per pixel
+  static const uint32_t FIRE_MIDDLE_BLEND_START =
+      ((FIRE_MIDDLE_START * 100UL - 33UL * (Count - 1)) << 15) / (33UL * (Count - 1));
+  static const uint32_t FIRE_MIDDLE_BLEND_STEP = (100UL << 15) / (33UL * (Count - 1));
+  static const uint32_t FIRE_TOP_BLEND_START =
+      ((FIRE_TOP_START * 100UL - 66UL * (Count - 1)) << 15) / (34UL * (Count - 1));
+  static const uint32_t FIRE_TOP_BLEND_STEP = (100UL << 15) / (34UL * (Count - 1));
+
+  // Set every pixel to the same color
+  static void fill(uint32_t color)
+  {
+    for (index_t i = 0; i < Count; i++)
+    {
+      strip.setPixelColor(i, color);
+    }
+  }
+
+  // Full rainbow across the strip, starting at baseHue on the first pixel.
+  // Each frame is the same wheel read at a shifted offset: no HSV or gamma math.
+  static void rainbow(uint16_t baseHue)
+  {
+    uint16_t pixelHue = baseHue;
+    for (index_t i = 0; i < Count; i++)
+    {
+      strip.setPixelColor(i, rainbowWheelColor(pixelHue));
+      pixelHue += HUE_STEP;
+    }
+  }
+
+  // Fire gradient (inner at the bottom, outer at the top) with random flicker
+  static void fire(uint16_t innerHue, uint16_t middleHue, uint16_t outerHue, uint8_t satReduction)
+  {
+    index_t i = 0;
+
+    // Bottom third: inner fire color
+    for (; i < FIRE_MIDDLE_START; i++)
+    {
+      firePixel(i, innerHue, 255);
+    }
+
+    // Middle third: blend between inner and middle
+    int32_t delta = (int32_t)middleHue - innerHue;
+    uint32_t blend = FIRE_MIDDLE_BLEND_START;
+    for (; i < FIRE_TOP_START; i++)
+    {
+      firePixel(i, innerHue + (uint16_t)((delta * (int32_t)blend) >> 15), 255);
+      blend += FIRE_MIDDLE_BLEND_STEP;
+    }
+
+    // Top third: blend between middle and outer, desaturating towards the tips
+    delta = (int32_t)outerHue - middleHue;
+    blend = FIRE_TOP_BLEND_START;
+    for (; i < Count; i++)
+    {
+      uint8_t sat = 255 - (uint8_t)((blend * satReduction) >> 15);
+      firePixel(i, middleHue + (uint16_t)((delta * (int32_t)blend) >> 15), sat);
+      blend += FIRE_TOP_BLEND_STEP;
+    }
+  }
+
+  // Spectrum bars: bands spread evenly over the strip, each in its own hue
+  // and as bright as its level (0..255)
+  static void spectrum(const uint8_t *levels, uint8_t bands, uint16_t baseHue, uint16_t bandHueStep)
+  {
+    uint8_t band = 0;
+    uint16_t bandPos = 0; // Steps pixels across bands without dividing
+    for (index_t i = 0; i < Count; i++)
+    {
+      uint32_t color = rainbowWheelColor(baseHue + band * bandHueStep);
+      uint16_t scale = strip.gamma8(levels[band]) + 1;
+      uint8_t r = ((uint8_t)(color >> 16) * scale) >> 8;
+      uint8_t g = ((uint8_t)(color >> 8) * scale) >> 8;
+      uint8_t b = ((uint8_t)color * scale) >> 8;
+      strip.setPixelColor(i, r, g, b);
+
+      bandPos += bands;
+      while (bandPos >= Count)
+      {
+        bandPos -= Count;
+        band++;
+      }
+    }
+  }
+
+  static void firePixel(index_t i, uint16_t hue, uint8_t sat)
+  {
+    // Add random flicker to brightness (60-100% of set brightness)
+    uint8_t flicker = random(153, 256); // 60-100% of 255
+    uint8_t val = (uint8_t)((255 * flicker) / 256);
+
+    // Additional flicker: randomly dim some LEDs more
+    if (random(0, 100) < 30) // 30% chance
+    {
+      val = val / 2; // Dim to 50%
+    }
+
+    uint32_t color = strip.ColorHSV(hue, sat, val);
+    strip.setPixelColor(i, strip.gamma32(color));
+  }
+};
+
+typedef StripKernel<LED_COUNT> Kernel;
+
+// --- Input layer: pots with hysteresis, button, change events ---
+struct PotInput
+{
+  uint8_t pin;
+  int raw;      // Last raw reading (0..1023), for debug output
+  int sum;      // Moving average state: filtered << POT_SMOOTHING_SHIFT
+  int filtered; // Exponential moving average of the raw readings
+  int value;    // Filtered value with hysteresis; only changes with an event
+};
+
+PotInput brightnessPot = {POT_PIN_BRIGHTNESS, 512, 512 << POT_SMOOTHING_SHIFT, 512, 512}; // Start at mid brightness
+PotInput huePot = {POT_PIN_HUE, 0, 0, 0, 0};
+PotInput speedPot = {POT_PIN_SPEED, 512, 512 << POT_SMOOTHING_SHIFT, 512, 512}; // Start at mid speed
+
+// Read one pot; returns true when its value moved outside the deadband
+bool updatePot(PotInput &pot)
 {
   // Multiple dummy reads to fully settle ADC when switching pins
   for (int i = 0; i < 3; i++)
   {
-    analogRead(POT_PIN_SPEED);
+    analogRead(pot.pin);
   }
   delayMicroseconds(100);
 
   // Read raw pot value (0..1023)
-  int raw = analogRead(POT_PIN_SPEED);
+  pot.raw = analogRead(pot.pin);
+
+  // Exponential moving average, kept with POT_SMOOTHING_SHIFT extra bits so
+  // it settles exactly on a steady reading instead of stalling a few counts
+  // short of it
+  pot.sum += pot.raw - (pot.sum >> POT_SMOOTHING_SHIFT);
+  pot.filtered = pot.sum >> POT_SMOOTHING_SHIFT;
+
+  // Snap to the calibrated ends, so full/zero brightness and the first/last
+  // hue stay reachable through the deadband below
+  int target = pot.filtered;
+  if (target <= POT_MIN + POT_HYSTERESIS / 2)
+  {
+    target = POT_MIN;
+  }
+  else if (target >= POT_MAX - POT_HYSTERESIS / 2)
+  {
+    target = POT_MAX;
+  }
 
-  // Simple smoothing (exponential moving average)
-  static int filtered = 512; // Start at mid speed
-  filtered = (filtered * 7 + raw) / 8;
+  // Hysteresis: ignore ADC noise smaller than the deadband
+  bool atRail = (target == POT_MIN || target == POT_MAX);
+  if (abs(target - pot.value) > POT_HYSTERESIS || (atRail && target != pot.value))
+  {
+    pot.value = target;
+    return true;
+  }
+  return false;
+}
 
+// Debounced button; returns true once per press
+bool updateButton()
+{
+  bool pressed = false;
+  bool reading = digitalRead(BUTTON_PIN);
+
+  if (reading != lastButtonState)
+  {
+    lastDebounceTime = millis();
+  }
+
+  if ((millis() - lastDebounceTime) > debounceDelay)
+  {
+    static bool buttonState = HIGH;
+
+    if (reading != buttonState)
+    {
+      buttonState = reading;
+      pressed = (buttonState == LOW);
+    }
+  }
+
+  lastButtonState = reading;
+  return pressed;
+}
+
+// Poll all inputs and return the EVENT_* flags for what changed
+uint8_t pollInputs()
+{
+  uint8_t events = 0;
+
+  if (updatePot(brightnessPot))
+  {
+    events |= EVENT_BRIGHTNESS;
+  }
+  if (updatePot(huePot))
+  {
+    events |= EVENT_HUE;
+  }
+  if (updatePot(speedPot))
+  {
+    events |= EVENT_SPEED;
+  }
+  if (updateButton())
+  {
+    events |= EVENT_BUTTON;
+  }
+
+  return events;
+}
+
+// --- Helper: convert brightness knob to brightness (0..255) ---
+uint8_t readBrightnessFromPot()
+{
+  // Map actual pot range to 0..255 (NeoPixel brightness is 8-bit)
+  uint8_t brightness = map(brightnessPot.value, POT_MIN, POT_MAX, 0, 255);
+  brightness = constrain(brightness, 0, 255); // Ensure we stay within bounds
+  return brightness;
+}
+
+// --- Helper: convert hue knob to hue (0..65535) ---
+uint16_t readHueFromPot()
+{
+  // Map actual pot range to 0..65535 (NeoPixel HSV hue is 16-bit)
+  uint32_t hue = map(huePot.value, POT_MIN, POT_MAX, 0, 65535);
+  hue = constrain(hue, 0, 65535); // Ensure we stay within bounds
+  return (uint16_t)hue;
+}
+
+// --- Helper: convert speed knob to delay time (10..1000ms) ---
+uint16_t readSpeedFromPot()
+{
   // Map actual pot range to 1000..10 (delay in ms - lower = slower, higher = faster)
-  uint16_t speed = map(filtered, POT_MIN, POT_MAX, 1000, 10);
+  uint16_t speed = map(speedPot.value, POT_MIN, POT_MAX, 1000, 10);
   speed = constrain(speed, 10, 1000); // Ensure we stay within bounds
   return speed;
 }
 
-// Effect 0: Off
-void effectOff()
+// --- Helper: idle the CPU until wakeTime (millis) ---
+void sleepUntil(unsigned long wakeTime)
 {
-  strip.clear();
-  strip.setBrightness(0);
-  strip.show();
-  delay(100);
+#ifdef __AVR__
+  // Idle mode keeps timers and serial running; the millis() timer wakes us
+  // about every millisecond to check the deadline
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  while ((long)(wakeTime - millis()) > 0)
+  {
+    sleep_mode();
+  }
+#else
+  while ((long)(wakeTime - millis()) > 0)
+  {
+    yield();
+  }
+#endif
 }
 
-// Effect 1: White light with warmth control
-void whiteLight()
+// --- Sound spectrum analyzer (microphone on MIC_PIN) ---
+// Sine table for the FFT twiddle factors: sin(2*pi*k/AUDIO_SAMPLES) in Q15,
+// three quarters of a period (cosines are read a quarter period further on)
+const int16_t AUDIO_SINE[AUDIO_SAMPLES * 3 / 4] PROGMEM = {
+    0, 1608, 3212, 4808, 6393, 7962, 9512, 11039, 12539, 14010, 15446, 16846,
+    18204, 19519, 20787, 22005, 23170, 24279, 25329, 26319, 27245, 28105, 28898, 29621,
+    30273, 30852, 31356, 31785, 32137, 32412, 32609, 32728, 32767, 32728, 32609, 32412,
+    32137, 31785, 31356, 30852, 30273, 29621, 28898, 28105, 27245, 26319, 25329, 24279,
+    23170, 22005, 20787, 19519, 18204, 16846, 15446, 14010, 12539, 11039, 9512, 7962,
+    6393, 4808, 3212, 1608, 0, -1608, -3212, -4808, -6393, -7962, -9512, -11039,
+    -12539, -14010, -15446, -16846, -18204, -19519, -20787, -22005, -23170, -24279, -25329, -26319,
+    -27245, -28105, -28898, -29621, -30273, -30852, -31356, -31785, -32137, -32412, -32609, -32728,
+};
+
+// First half of a Hann window in Q15 (the second half mirrors it)
+const int16_t AUDIO_WINDOW[AUDIO_SAMPLES / 2] PROGMEM = {
+    0, 20, 80, 180, 320, 499, 717, 973, 1267, 1597, 1965, 2367,
+    2803, 3273, 3775, 4308, 4870, 5461, 6078, 6721, 7387, 8075, 8784, 9511,
+    10254, 11013, 11785, 12569, 13361, 14161, 14967, 15776, 16586, 17396, 18203, 19006,
+    19803, 20591, 21369, 22135, 22886, 23622, 24340, 25039, 25716, 26371, 27001, 27605,
+    28181, 28729, 29247, 29733, 30186, 30606, 30990, 31340, 31652, 31927, 32164, 32363,
+    32522, 32642, 32722, 32762,
+};
+
+// First FFT bin of each band (bins are about 75 Hz wide), log spaced from
+// 75 Hz to 4.8 kHz with at least 3 bins per band, so a tone stays inside its
+// band's window main lobe; the last entry ends the top band at the Nyquist bin
+const uint8_t AUDIO_BAND_BINS[AUDIO_BANDS + 1] PROGMEM = {1, 4, 7, 10, 14, 20, 28, 40, 64};
+
+// The real input block is packed into a complex one of AUDIO_FFT_POINTS:
+// even readings in the real part, odd readings in the imaginary part
+int16_t audioSamples[AUDIO_FFT_POINTS]; // Even readings, then the FFT real part
+int16_t audioImag[AUDIO_FFT_POINTS];    // Odd readings, then the FFT imaginary part
+volatile uint8_t audioSampleCount = AUDIO_SAMPLES;
+
+// Reading n (0..AUDIO_SAMPLES-1) of the captured block
+inline int16_t &audioSample(uint8_t n)
 {
-  int rawBrightness = analogRead(POT_PIN_BRIGHTNESS);
-  int rawWarmth = analogRead(POT_PIN_HUE);
+  return (n & 1) ? audioImag[n >> 1] : audioSamples[n >> 1];
+}
 
-  uint8_t brightness = readBrightnessFromPot();
+#ifdef __AVR__
+// One free-running conversion per interrupt; stops itself when the block is full
+ISR(ADC_vect)
+{
+  audioSample(audioSampleCount) = ADC;
+  if (++audioSampleCount >= AUDIO_SAMPLES)
+  {
+    // Back to single conversions so analogRead() works again
+    ADCSRA &= ~(_BV(ADATE) | _BV(ADIE));
+  }
+}
+#endif
 
-  // Use hue pot to control warmth (0 = very warm, 1023 = very cool)
-  // Map actual pot range to 0-1023 to ensure full temperature range is accessible
-  int warmth = map(rawWarmth, POT_MIN, POT_MAX, 0, 1023);
-  warmth = constrain(warmth, 0, 1023);
-
-  // Map warmth to RGB values with 8 points (5 warm, 3 cool)
-  // Point 0 (0): Very warm candlelight (255, 147, 41)
-  // Point 1 (146): Warm amber (255, 169, 87)
-  // Point 2 (292): Warm (255, 197, 143)
-  // Point 3 (438): Soft warm (255, 214, 170)
-  // Point 4 (585): Warm white (255, 241, 224) - warmest midpoint
-  // Point 5 (731): Slightly cool (245, 243, 255)
-  // Point 6 (877): Cool (225, 235, 255)
-  // Point 7 (1023): Very cool daylight (201, 226, 255)
-  uint8_t r, g, b;
+// Record one block of AUDIO_SAMPLES microphone readings (see audioSample())
+void captureAudio()
+{
+  // A normal read selects the microphone input and lets it settle
+  analogRead(MIC_PIN);
+  audioSampleCount = 0;
+
+#ifdef __AVR__
+  // Free-running mode (ADCSRB trigger source 0), sampled from the ADC interrupt.
+  // Writing ADIF clears the flag left by analogRead() so it is not a sample.
+  ADCSRB = 0;
+  ADCSRA |= _BV(ADIF) | _BV(ADATE) | _BV(ADIE) | _BV(ADSC);
+
+  // Idle until the block is complete; every sample interrupt wakes us.
+  // Interrupts are off between the check and sleep_cpu(): sei() only takes
+  // effect after the next instruction, so a sample that completes the block
+  // cannot slip in before we sleep and leave us waiting for the next timer tick.
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  cli();
+  while (audioSampleCount < AUDIO_SAMPLES)
+  {
+    sleep_enable();
+    sei();
+    sleep_cpu();
+    sleep_disable();
+    cli();
+  }
+  sei();
+#else
+  while (audioSampleCount < AUDIO_SAMPLES)
+  {
+    audioSample(audioSampleCount++) = analogRead(MIC_PIN);
+    delayMicroseconds(AUDIO_SAMPLE_PERIOD_US);
+  }
+#endif
+}
 
-  if (warmth < 146)
+// log2(value) in fixed point with 5 fractional bits (value must be > 0)
+int16_t log2x32(uint16_t value)
+{
+  // Normalise into 32..63, counting the doublings
+  int16_t result = 5 * 32;
+  while (value >= 64)
   {
-    // Very warm to warm amber (0-146)
-    r = 255;
-    g = map(warmth, 0, 146, 147, 169);
-    b = map(warmth, 0, 146, 41, 87);
+    value >>= 1;
+    result += 32;
   }
-  else if (warmth < 292)
+  while (value < 32)
   {
-    // Warm amber to warm (146-292)
-    r = 255;
-    g = map(warmth, 146, 292, 169, 197);
-    b = map(warmth, 146, 292, 87, 143);
+    value <<= 1;
+    result -= 32;
   }
-  else if (warmth < 438)
+  return result + value - 32;
+}
+
+// Band magnitude -> level 0..255 on a log scale: 32 steps per doubling above
+// AUDIO_NOISE_FLOOR, so quiet and loud sounds both stay visible
+uint8_t audioLevel(uint16_t magnitude)
+{
+  if (magnitude <= AUDIO_NOISE_FLOOR)
   {
-    // Warm to soft warm (292-438)
-    r = 255;
-    g = map(warmth, 292, 438, 197, 214);
-    b = map(warmth, 292, 438, 143, 170);
+    return 0;
   }
-  else if (warmth < 585)
+
+  int16_t level = log2x32(magnitude) - log2x32(AUDIO_NOISE_FLOOR);
+  return constrain(level, 0, 255);
+}
+
+// Q15 fixed-point multiply
+inline int16_t fixMul(int16_t a, int16_t b)
+{
+  return ((int32_t)a * b) >> 15;
+}
+
+// In-place radix-2 FFT of AUDIO_FFT_POINTS points. Every stage halves its
+// values so nothing overflows: the result is the true spectrum / AUDIO_FFT_POINTS.
+void fixFFT(int16_t *re, int16_t *im)
+{
+  // Reorder the input into bit-reversed index order
+  uint8_t mr = 0;
+  for (uint8_t m = 1; m < AUDIO_FFT_POINTS; m++)
   {
-    // Soft warm to warm white (438-585)
-    r = 255;
-    g = map(warmth, 438, 585, 214, 241);
-    b = map(warmth, 438, 585, 170, 224);
+    uint8_t l = AUDIO_FFT_POINTS;
+    do
+    {
+      l >>= 1;
+    } while (mr + l > AUDIO_FFT_POINTS - 1);
+    mr = (mr & (l - 1)) + l;
+
+    if (mr > m)
+    {
+      int16_t t = re[m];
+      re[m] = re[mr];
+      re[mr] = t;
+      t = im[m];
+      im[m] = im[mr];
+      im[mr] = t;
+    }
   }
-  else if (warmth < 731)
+
+  // Butterflies, one stage per doubling of the transform length. The sine
+  // table has AUDIO_SAMPLES steps, twice the transform length.
+  uint8_t k = AUDIO_SAMPLES_LOG2 - 1;
+  for (uint8_t l = 1; l < AUDIO_FFT_POINTS; l <<= 1)
   {
-    // Warm white to slightly cool (585-731)
-    r = map(warmth, 585, 731, 255, 245);
-    g = map(warmth, 585, 731, 241, 243);
-    b = map(warmth, 585, 731, 224, 255);
+    for (uint8_t m = 0; m < l; m++)
+    {
+      uint8_t j = m << k;
+      int16_t wr = (int16_t)pgm_read_word(&AUDIO_SINE[j + AUDIO_SAMPLES / 4]) >> 1;
+      int16_t wi = -((int16_t)pgm_read_word(&AUDIO_SINE[j]) >> 1);
+
+      for (uint8_t i = m; i < AUDIO_FFT_POINTS; i += l << 1)
+      {
+        uint8_t p = i + l;
+        int16_t tr = fixMul(wr, re[p]) - fixMul(wi, im[p]);
+        int16_t ti = fixMul(wr, im[p]) + fixMul(wi, re[p]);
+        int16_t qr = re[i] >> 1;
+        int16_t qi = im[i] >> 1;
+        re[p] = qr - tr;
+        im[p] = qi - ti;
+        re[i] = qr + tr;
+        im[i] = qi + ti;
+      }
+    }
+    k--;
   }
-  else if (warmth < 877)
+}
+
+// Turn the FFT of the packed block into bins 1..AUDIO_FFT_POINTS-1 of the
+// spectrum of the AUDIO_SAMPLES real readings (same scale as fixFFT()).
+// Bins k and AUDIO_FFT_POINTS-k are built from the same pair of FFT outputs.
+void splitRealFFT(int16_t *re, int16_t *im)
+{
+  for (uint8_t k = 1; k <= AUDIO_FFT_POINTS / 2; k++)
   {
-    // Slightly cool to cool (731-877)
-    r = map(warmth, 731, 877, 245, 225);
-    g = map(warmth, 731, 877, 243, 235);
-    b = 255;
+    uint8_t m = AUDIO_FFT_POINTS - k;
+
+    // Spectra of the even and odd readings (halved before adding, so the
+    // sums stay in 16 bits)
+    int16_t evenRe = (re[k] >> 1) + (re[m] >> 1);
+    int16_t evenIm = (im[k] >> 1) - (im[m] >> 1);
+    int16_t oddRe = (im[k] >> 1) + (im[m] >> 1);
+    int16_t oddIm = (re[m] >> 1) - (re[k] >> 1);
+
+    // Rotate the odd spectrum by exp(-2*pi*i*k/AUDIO_SAMPLES)
+    int16_t wr = pgm_read_word(&AUDIO_SINE[k + AUDIO_SAMPLES / 4]);
+    int16_t wi = pgm_read_word(&AUDIO_SINE[k]);
+    int16_t tr = fixMul(wr, oddRe) + fixMul(wi, oddIm);
+    int16_t ti = fixMul(wr, oddIm) - fixMul(wi, oddRe);
+
+    // Bin m is the conjugate of the mirrored combination
+    re[k] = evenRe + tr;
+    im[k] = evenIm + ti;
+    re[m] = evenRe - tr;
+    im[m] = ti - evenIm;
   }
-  else
+}
+
+// Spectrum of the captured block (overwritten); writes a 0..255 level per
+// band, taken from the loudest bin in the band
+void analyzeAudio(uint8_t *levels)
+{
+  // Remove the microphone's DC bias. The mean is weighted by the window, so
+  // a tone that does not fit the block a whole number of times leaves no DC
+  // behind to leak into the lowest band.
+  uint32_t weighted = 0;
+  uint32_t weights = 0;
+  for (uint8_t i = 0; i < AUDIO_SAMPLES / 2; i++)
   {
-    // Cool to very cool (877-1023)
-    r = map(warmth, 877, 1023, 225, 201);
-    g = map(warmth, 877, 1023, 235, 226);
-    b = 255;
+    uint16_t w = pgm_read_word(&AUDIO_WINDOW[i]);
+    weighted += (uint32_t)w * (audioSample(i) + audioSample(AUDIO_SAMPLES - 1 - i));
+    weights += w;
   }
+  int16_t bias = weighted / (weights >> 4); // Scaled by 32, like the readings below
+
+  // Scale the 10-bit readings up to Q15 and apply the window
+  for (uint8_t i = 0; i < AUDIO_SAMPLES / 2; i++)
+  {
+    int16_t w = pgm_read_word(&AUDIO_WINDOW[i]);
+    int16_t &first = audioSample(i);
+    int16_t &last = audioSample(AUDIO_SAMPLES - 1 - i);
+    first = fixMul(first * 32 - bias, w);
+    last = fixMul(last * 32 - bias, w);
+  }
+
+  fixFFT(audioSamples, audioImag);
+  splitRealFFT(audioSamples, audioImag);
+
+  uint8_t bin = pgm_read_byte(&AUDIO_BAND_BINS[0]);
+  for (uint8_t band = 0; band < AUDIO_BANDS; band++)
+  {
+    uint8_t end = pgm_read_byte(&AUDIO_BAND_BINS[band + 1]);
+    uint16_t peak = 0;
+    for (; bin < end; bin++)
+    {
+      // |X| ~= max + min / 2 of the absolute real and imaginary parts
+      uint16_t re = abs(audioSamples[bin]);
+      uint16_t im = abs(audioImag[bin]);
+      uint16_t magnitude = (re > im) ? re + (im >> 1) : im + (re >> 1);
+      peak = max(peak, magnitude);
+    }
+    levels[band] = audioLevel(peak);
+  }
+}
+
+// Each effect draws one frame and returns the delay (ms) until its next
+// frame, or FRAME_STATIC if it only needs redrawing when an input changes
+
+// Effect 0: Off
+uint16_t effectOff()
+{
+  strip.clear();
+  strip.setBrightness(0);
+  strip.show();
+  return FRAME_STATIC;
+}
+
+// Effect 1: White light with warmth control
+uint16_t whiteLight()
+{
+  int rawBrightness = brightnessPot.raw;
+  int rawWarmth = huePot.raw;
+
+  uint8_t brightness = readBrightnessFromPot();
+
+  // Use hue pot to control warmth (0 = very warm, 1023 = very cool)
+  // Map actual pot range to 0-1023 to ensure full temperature range is accessible
+  int warmth = map(huePot.value, POT_MIN, POT_MAX, 0, WARMTH_MAX);
+  warmth = constrain(warmth, 0, WARMTH_MAX);
+
+  // Look up the interpolated white from the calibrated warmth table
+  uint32_t color = whiteFromWarmth(warmth);
 
   // Debug output every 1000ms (1 second)
   static unsigned long lastPrint = 0;
@@ -191,61 +885,37 @@ void whiteLight()
     Serial.print(brightness);
     Serial.print(" | Warmth pot: ");
     Serial.print(rawWarmth);
-    Serial.print(" -> ");
-
-    // Determine warmth range and description
-    if (warmth < 146)
-    {
-      Serial.println("Point 0-1 (Very warm candlelight to Warm amber)");
-    }
-    else if (warmth < 292)
-    {
-      Serial.println("Point 1-2 (Warm amber to Warm)");
-    }
-    else if (warmth < 438)
-    {
-      Serial.println("Point 2-3 (Warm to Soft warm)");
-    }
-    else if (warmth < 585)
-    {
-      Serial.println("Point 3-4 (Soft warm to Warm white)");
-    }
-    else if (warmth < 731)
-    {
-      Serial.println("Point 4-5 (Warm white to Slightly cool)");
-    }
-    else if (warmth < 877)
-    {
-      Serial.println("Point 5-6 (Slightly cool to Cool)");
-    }
-    else
-    {
-      Serial.println("Point 6-7 (Cool to Very cool daylight)");
-    }
+    Serial.print(" -> ~");
+    Serial.print(warmthToKelvin(warmth));
+    Serial.print("K RGB(");
+    Serial.print((uint8_t)(color >> 16));
+    Serial.print(",");
+    Serial.print((uint8_t)(color >> 8));
+    Serial.print(",");
+    Serial.print((uint8_t)color);
+    Serial.println(")");
 
     lastPrint = millis();
   }
 
-  // Create color with gamma correction
-  uint32_t color = strip.Color(r, g, b);
+  // Gamma correction
   color = strip.gamma32(color);
 
+  // Set brightness first: pixels are stored scaled by the current brightness
+  strip.setBrightness(brightness);
+
   // Set all pixels to the white color
-  for (int i = 0; i < LED_COUNT; i++)
-  {
-    strip.setPixelColor(i, color);
-  }
+  Kernel::fill(color);
 
-  strip.setBrightness(brightness);
   strip.show();
-  delay(10);
+  return FRAME_STATIC;
 }
 
 // Effect 2: Knob controls hue (solid color)
-void solidHue()
+uint16_t solidHue()
 {
-  int rawBrightness = analogRead(POT_PIN_BRIGHTNESS);
-  int rawHue = analogRead(POT_PIN_HUE);
+  int rawBrightness = brightnessPot.raw;
+  int rawHue = huePot.raw;
 
   uint16_t hue = readHueFromPot();
   uint8_t brightness = readBrightnessFromPot();
@@ -273,28 +943,25 @@ void solidHue()
 
   strip.setBrightness(brightness);
 
-  for (int i = 0; i < LED_COUNT; i++)
-  {
-    strip.setPixelColor(i, c);
-  }
+  Kernel::fill(c);
 
   strip.show();
-  delay(10);
+  return FRAME_STATIC;
 }
 
 // Effect 3: Pulse with hue control
-void pulseHue()
+uint16_t pulseHue()
 {
   static uint8_t brightness = 0;
   static int8_t fadeAmount = 5;
 
-  int rawBrightness = analogRead(POT_PIN_BRIGHTNESS);
-  int rawHue = analogRead(POT_PIN_HUE);
-  int rawSpeed = analogRead(POT_PIN_SPEED);
+  int rawBrightness = brightnessPot.raw;
+  int rawHue = huePot.raw;
+  int rawSpeed = speedPot.raw;
 
   uint16_t hue = readHueFromPot();
   uint8_t maxBrightness = readBrightnessFromPot();
-  uint8_t speed = readSpeedFromPot();
+  uint16_t speed = readSpeedFromPot();
 
   // Debug output every 1000ms (1 second)
   static unsigned long lastPrint = 0;
@@ -321,10 +988,7 @@ void pulseHue()
   uint32_t c = strip.ColorHSV(hue, 255, 255);
   c = strip.gamma32(c);
 
-  for (int i = 0; i < LED_COUNT; i++)
-  {
-    strip.setPixelColor(i, c);
-  }
+  Kernel::fill(c);
 
   strip.setBrightness(brightness);
   strip.show();
@@ -338,21 +1002,21 @@ void pulseHue()
     fadeAmount = -fadeAmount;
   }
 
-  delay(speed);
+  return speed;
 }
 
 // Effect 4: Chase effect with hue control
-void chaseHue()
+uint16_t chaseHue()
 {
-  static uint8_t position = 0;
+  static Kernel::index_t position = 0;
 
-  int rawBrightness = analogRead(POT_PIN_BRIGHTNESS);
-  int rawHue = analogRead(POT_PIN_HUE);
-  int rawSpeed = analogRead(POT_PIN_SPEED);
+  int rawBrightness = brightnessPot.raw;
+  int rawHue = huePot.raw;
+  int rawSpeed = speedPot.raw;
 
   uint16_t hue = readHueFromPot();
   uint8_t brightness = readBrightnessFromPot();
-  uint8_t speed = readSpeedFromPot();
+  uint16_t speed = readSpeedFromPot();
 
   // Debug output every 1000ms (1 second)
   static unsigned long lastPrint = 0;
@@ -395,22 +1059,22 @@ void chaseHue()
     position = 0;
   }
 
-  delay(speed);
+  return speed;
 }
 
 // Effect 5: Rainbow Fade In/Out
-void rainbowFade()
+uint16_t rainbowFade()
 {
   static uint16_t hue = 0;
   static uint8_t brightness = 0;
   static int8_t fadeAmount = 5;
 
-  int rawBrightness = analogRead(POT_PIN_BRIGHTNESS);
-  int rawSpeed = analogRead(POT_PIN_SPEED);
+  int rawBrightness = brightnessPot.raw;
+  int rawSpeed = speedPot.raw;
 
   // Get max brightness and speed from potentiometers
   uint8_t maxBrightness = readBrightnessFromPot();
-  uint8_t speed = readSpeedFromPot();
+  uint16_t speed = readSpeedFromPot();
 
   // Debug output every 1000ms (1 second)
   static unsigned long lastPrint = 0;
@@ -429,14 +1093,8 @@ void rainbowFade()
     lastPrint = millis();
   }
 
-  // Manually create rainbow with gamma correction
-  for (int i = 0; i < LED_COUNT; i++)
-  {
-    uint16_t pixelHue = hue + (i * 65536L / LED_COUNT);
-    uint32_t color = strip.ColorHSV(pixelHue, 255, 255);
-    color = strip.gamma32(color);
-    strip.setPixelColor(i, color);
-  }
+  // Rotate the precomputed, gamma-corrected rainbow wheel by the current hue
+  Kernel::rainbow(hue);
 
   strip.setBrightness(brightness);
   strip.show();
@@ -450,22 +1108,21 @@ void rainbowFade()
   }
 
   hue += 127;
-  delay(speed);
+  return speed;
 }
 
 // Effect 6: Fire Effect
-void fireEffect()
+uint16_t fireEffect()
 {
-  int rawBrightness = analogRead(POT_PIN_BRIGHTNESS);
-  int rawHue = analogRead(POT_PIN_HUE);
-  int rawSpeed = analogRead(POT_PIN_SPEED);
+  int rawBrightness = brightnessPot.raw;
+  int rawHue = huePot.raw;
+  int rawSpeed = speedPot.raw;
 
   uint8_t brightness = readBrightnessFromPot();
-  uint16_t huePot = readHueFromPot();
   uint16_t speed = readSpeedFromPot();
 
   // Map hue pot to select fire color palette (using calibrated range -> 0-5)
-  uint8_t palette = map(analogRead(POT_PIN_HUE), POT_MIN, POT_MAX, 0, 5);
+  uint8_t palette = map(huePot.value, POT_MIN, POT_MAX, 0, 5);
   palette = constrain(palette, 0, 5); // Ensure we can reach all palettes
 
   // Debug output every 1000ms
@@ -552,64 +1209,21 @@ void fireEffect()
   }
 
   // Draw fire on each LED
-  for (int i = 0; i < LED_COUNT; i++)
-  {
-    // Calculate position ratio (0.0 at bottom, 1.0 at top)
-    float position = (float)i / (float)(LED_COUNT - 1);
-
-    // Select color based on position
-    uint16_t hue;
-    uint8_t sat = 255; // Full saturation by default
-
-    if (position < 0.33)
-    {
-      // Bottom third: inner fire color
-      hue = innerHue;
-    }
-    else if (position < 0.66)
-    {
-      // Middle third: blend between inner and middle
-      float blend = (position - 0.33) / 0.33;
-      hue = innerHue + (uint16_t)((middleHue - innerHue) * blend);
-    }
-    else
-    {
-      // Top third: blend between middle and outer
-      float blend = (position - 0.66) / 0.34;
-      hue = middleHue + (uint16_t)((outerHue - middleHue) * blend);
-      // Reduce saturation at the tips for white-hot effect
-      // Hot fire palette gets extra desaturation for whiter tips
-      uint8_t satReduction = (palette == 1) ? 93 : 80;
-      sat = 255 - (uint8_t)(blend * satReduction);
-    }
-
-    // Add random flicker to brightness (60-100% of set brightness)
-    uint8_t flicker = random(153, 256); // 60-100% of 255
-    uint8_t val = (uint8_t)((255 * flicker) / 256);
-
-    // Additional flicker: randomly dim some LEDs more
-    if (random(0, 100) < 30) // 30% chance
-    {
-      val = val / 2; // Dim to 50%
-    }
-
-    uint32_t color = strip.ColorHSV(hue, sat, val);
-    color = strip.gamma32(color);
-    strip.setPixelColor(i, color);
-  }
+  // Hot fire palette gets extra desaturation for whiter tips
+  Kernel::fire(innerHue, middleHue, outerHue, (palette == 1) ? 93 : 80);
 
   strip.show();
-  delay(speed / 2); // Faster updates for more dynamic flicker
+  return speed / 2; // Faster updates for more dynamic flicker
 }
 
 // Effect 7: White Flicker
-void whiteFastFlicker()
+uint16_t whiteFastFlicker()
 {
-  int rawBrightness = analogRead(POT_PIN_BRIGHTNESS);
-  int rawSpeed = analogRead(POT_PIN_SPEED);
+  int rawBrightness = brightnessPot.raw;
+  int rawSpeed = speedPot.raw;
 
   uint8_t brightness = readBrightnessFromPot();
-  uint8_t speed = readSpeedFromPot();
+  uint16_t speed = readSpeedFromPot();
 
   // Debug output every 1000ms (1 second)
   static unsigned long lastPrint = 0;
@@ -639,7 +1253,68 @@ void whiteFastFlicker()
   }
 
   strip.show();
-  delay(speed);
+  return speed;
+}
+
+// Effect 8: Sound Spectrum
+uint16_t soundSpectrum()
+{
+  static uint8_t levels[AUDIO_BANDS];
+
+  int rawBrightness = brightnessPot.raw;
+  int rawHue = huePot.raw;
+  int rawSpeed = speedPot.raw;
+
+  uint8_t brightness = readBrightnessFromPot();
+  uint16_t hue = readHueFromPot();
+  uint16_t speed = readSpeedFromPot();
+
+  // Speed pot sets how fast the bars fall back (left = slow, right = instant)
+  uint8_t decay = constrain(2000 / speed, 2, 200);
+
+  uint8_t bandLevels[AUDIO_BANDS];
+  captureAudio();
+  analyzeAudio(bandLevels);
+
+  // Bars jump up to a new peak immediately and fall back at the decay rate
+  for (uint8_t band = 0; band < AUDIO_BANDS; band++)
+  {
+    uint8_t fallen = (levels[band] > decay) ? levels[band] - decay : 0;
+    levels[band] = max(bandLevels[band], fallen);
+  }
+
+  // Debug output every 1000ms (1 second)
+  static unsigned long lastPrint = 0;
+  if (millis() - lastPrint > 1000)
+  {
+    Serial.print("[Sound Spectrum] Brightness pot: ");
+    Serial.print(rawBrightness);
+    Serial.print(" -> ");
+    Serial.print(brightness);
+    Serial.print(" | Hue pot: ");
+    Serial.print(rawHue);
+    Serial.print(" -> ");
+    Serial.print(hue);
+    Serial.print(" | Speed pot: ");
+    Serial.print(rawSpeed);
+    Serial.print(" -> Decay ");
+    Serial.print(decay);
+    Serial.print(" | Bands:");
+    for (uint8_t band = 0; band < AUDIO_BANDS; band++)
+    {
+      Serial.print(" ");
+      Serial.print(levels[band]);
+    }
+    Serial.println();
+    lastPrint = millis();
+  }
+
+  // Low bands start at the selected hue, high bands span 2/3 of the wheel
+  strip.setBrightness(brightness);
+  Kernel::spectrum(levels, AUDIO_BANDS, hue, 43690U / AUDIO_BANDS);
+  strip.show();
+
+  return AUDIO_FRAME_INTERVAL;
 }
 
 void setup()
@@ -674,101 +1349,117 @@ void setup()
   Serial.println("=========================\n");
 }
 
+// Draw one frame of the current effect; returns the delay until its next frame
+uint16_t renderEffect()
+{
+  switch (currentEffect)
+  {
+  case 0:
+    return effectOff();
+  case 1:
+    return whiteLight();
+  case 2:
+    return solidHue();
+  case 3:
+    return pulseHue();
+  case 4:
+    return chaseHue();
+  case 5:
+    return rainbowFade();
+  case 6:
+    return fireEffect();
+  case 7:
+    return whiteFastFlicker();
+  case 8:
+    return soundSpectrum();
+
+  default:
+    return effectOff();
+  }
+}
+
 void loop()
 {
-  bool reading = digitalRead(BUTTON_PIN);
+  static unsigned long lastPoll = 0;
+  static unsigned long lastFrame = 0;
+  static uint16_t frameDelay = FRAME_STATIC;
+  static bool redraw = true;
 
-  if (reading != lastButtonState)
+  uint8_t events = 0;
+  if (millis() - lastPoll >= INPUT_POLL_INTERVAL)
   {
-    lastDebounceTime = millis();
+    events = pollInputs();
+    lastPoll = millis();
   }
 
-  if ((millis() - lastDebounceTime) > debounceDelay)
+  if (events & EVENT_BUTTON)
   {
-    static bool buttonState = HIGH;
+    currentEffect = (currentEffect + 1) % NUM_EFFECTS;
 
-    if (reading != buttonState)
+    // Show effect name
+    Serial.print("Button pressed! Switching to effect ");
+    Serial.print(currentEffect);
+    Serial.print(": ");
+    switch (currentEffect)
     {
-      buttonState = reading;
-
-      if (buttonState == LOW)
-      {
-        currentEffect = (currentEffect + 1) % NUM_EFFECTS;
-
-        // Show effect name
-        Serial.print("Button pressed! Switching to effect ");
-        Serial.print(currentEffect);
-        Serial.print(": ");
-        switch (currentEffect)
-        {
-        case 0:
-          Serial.println("Off");
-          break;
-        case 1:
-          Serial.println("White Light");
-          break;
-        case 2:
-          Serial.println("Solid Hue");
-          break;
-        case 3:
-          Serial.println("Pulse Hue");
-          break;
-        case 4:
-          Serial.println("Chase Hue");
-          break;
-        case 5:
-          Serial.println("Rainbow Fade");
-          break;
-        case 6:
-          Serial.println("Fire Effect");
-          break;
-        case 7:
-          Serial.println("White Flicker");
-          break;
-        default:
-          Serial.println("Unknown");
-          break;
-        }
-
-        strip.clear();
-        strip.show();
-
-        delay(300);
-      }
+    case 0:
+      Serial.println("Off");
+      break;
+    case 1:
+      Serial.println("White Light");
+      break;
+    case 2:
+      Serial.println("Solid Hue");
+      break;
+    case 3:
+      Serial.println("Pulse Hue");
+      break;
+    case 4:
+      Serial.println("Chase Hue");
+      break;
+    case 5:
+      Serial.println("Rainbow Fade");
+      break;
+    case 6:
+      Serial.println("Fire Effect");
+      break;
+    case 7:
+      Serial.println("White Flicker");
+      break;
+    case 8:
+      Serial.println("Sound Spectrum");
+      break;
+    default:
+      Serial.println("Unknown");
+      break;
     }
-  }
 
-  lastButtonState = reading;
+    strip.clear();
+    strip.show();
 
-  switch (currentEffect)
+    delay(300);
+
+    redraw = true;
+  }
+
+  // Static effects redraw as soon as an input changes; animated effects pick
+  // up the new input values at their next frame
+  if (frameDelay == FRAME_STATIC && events)
   {
-  case 0:
-    effectOff();
-    break;
-  case 1:
-    whiteLight();
-    break;
-  case 2:
-    solidHue();
-    break;
-  case 3:
-    pulseHue();
-    break;
-  case 4:
-    chaseHue();
-    break;
-  case 5:
-    rainbowFade();
-    break;
-  case 6:
-    fireEffect();
-    break;
-  case 7:
-    whiteFastFlicker();
-    break;
+    redraw = true;
+  }
 
-  default:
-    effectOff();
-    break;
+  uint16_t interval = (frameDelay == FRAME_STATIC) ? STATIC_REFRESH_MS : frameDelay;
+  if (redraw || millis() - lastFrame >= interval)
+  {
+    frameDelay = renderEffect();
+    lastFrame = millis();
+    redraw = false;
+    interval = (frameDelay == FRAME_STATIC) ? STATIC_REFRESH_MS : frameDelay;
   }
+
+  // Sleep until the next input poll or animation deadline, whichever is first
+  unsigned long nextPoll = lastPoll + INPUT_POLL_INTERVAL;
+  unsigned long nextFrame = lastFrame + interval;
+  sleepUntil((long)(nextFrame - nextPoll) < 0 ? nextFrame : nextPoll);
 }
@@ -0,0 +1,56 @@
+// The per-pixel loops as they were before StripKernel, kept as a reference
+// for the kernel tests and benchmarks. Include after src/main.cpp.
+#pragma once
+
+// Fire gradient with float positions and per-pixel division
+void legacyFire(uint16_t innerHue, uint16_t middleHue, uint16_t outerHue, uint8_t palette)
+{
+  for (int i = 0; i < LED_COUNT; i++)
+  {
+    float position = (float)i / (float)(LED_COUNT - 1);
+
+    uint16_t hue;
+    uint8_t sat = 255;
+
+    if (position < 0.33)
+    {
+      hue = innerHue;
+    }
+    else if (position < 0.66)
+    {
+      float blend = (position - 0.33) / 0.33;
+      hue = innerHue + (uint16_t)(int32_t)((middleHue - innerHue) * blend);
+    }
+    else
+    {
+      float blend = (position - 0.66) / 0.34;
+      hue = middleHue + (uint16_t)(int32_t)((outerHue - middleHue) * blend);
+      uint8_t satReduction = (palette == 1) ? 93 : 80;
+      sat = 255 - (uint8_t)(blend * satReduction);
+    }
+
+    uint8_t flicker = random(153, 256);
+    uint8_t val = (uint8_t)((255 * flicker) / 256);
+
+    if (random(0, 100) < 30)
+    {
+      val = val / 2;
+    }
+
+    uint32_t color = strip.ColorHSV(hue, sat, val);
+    color = strip.gamma32(color);
+    strip.setPixelColor(i, color);
+  }
+}
+
+// Rainbow with ColorHSV + gamma32 and a 32-bit divide for every pixel
+void legacyRainbow(uint16_t hue)
+{
+  for (int i = 0; i < LED_COUNT; i++)
+  {
+    uint16_t pixelHue = hue + (i * 65536L / LED_COUNT);
+    uint32_t color = strip.ColorHSV(pixelHue, 255, 255);
+    color = strip.gamma32(color);
+    strip.setPixelColor(i, color);
+  }
+}
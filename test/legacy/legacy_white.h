@@ -0,0 +1,54 @@
+// The White Light map() ladder as it was before the warmth lookup table, kept
+// as a reference for the color temperature tests. Include after src/main.cpp.
+#pragma once
+
+// Color for a warmth of 0..1023, one map() segment per calibration point
+uint32_t legacyWhite(int warmth)
+{
+  uint8_t r, g, b;
+
+  if (warmth < 146)
+  {
+    r = 255;
+    g = map(warmth, 0, 146, 147, 169);
+    b = map(warmth, 0, 146, 41, 87);
+  }
+  else if (warmth < 292)
+  {
+    r = 255;
+    g = map(warmth, 146, 292, 169, 197);
+    b = map(warmth, 146, 292, 87, 143);
+  }
+  else if (warmth < 438)
+  {
+    r = 255;
+    g = map(warmth, 292, 438, 197, 214);
+    b = map(warmth, 292, 438, 143, 170);
+  }
+  else if (warmth < 585)
+  {
+    r = 255;
+    g = map(warmth, 438, 585, 214, 241);
+    b = map(warmth, 438, 585, 170, 224);
+  }
+  else if (warmth < 731)
+  {
+    r = map(warmth, 585, 731, 255, 245);
+    g = map(warmth, 585, 731, 241, 243);
+    b = map(warmth, 585, 731, 224, 255);
+  }
+  else if (warmth < 877)
+  {
+    r = map(warmth, 731, 877, 245, 225);
+    g = map(warmth, 731, 877, 243, 235);
+    b = 255;
+  }
+  else
+  {
+    r = map(warmth, 877, 1023, 225, 201);
+    g = map(warmth, 877, 1023, 235, 226);
+    b = 255;
+  }
+
+  return strip.Color(r, g, b);
+}
@@ -0,0 +1,221 @@
+// Adafruit NeoPixel stand-in for the native test environment. Color math
+// matches the library (ColorHSV, gamma 2.6, brightness scaling of the pixel
+// buffer); show() counts frames and advances the simulated clock by the
+// WS2812 transfer time.
+#pragma once
+
+#include <Arduino.h>
+
+#define NEO_GRB 0x52
+#define NEO_KHZ800 0x0000
+
+class Adafruit_NeoPixel
+{
+public:
+  Adafruit_NeoPixel(uint16_t n, int16_t pin, uint16_t type)
+      : showCount(0), lastShowMicros(0), numLEDs(n), brightness(0)
+  {
+    (void)pin;
+    (void)type;
+    pixels = new uint32_t[n]();
+  }
+
+  void begin()
+  {
+  }
+
+  // 30us per LED (24 bits at 800 kHz) plus the 300us latch
+  void show()
+  {
+    showCount++;
+    lastShowMicros = simMicros;
+    simMicros += 30UL * numLEDs + 300;
+  }
+
+  void clear()
+  {
+    memset(pixels, 0, numLEDs * sizeof(uint32_t));
+  }
+
+  // Like the library, pixels are stored already scaled by the brightness
+  // (stored as b + 1, 0 = full), and changing it rescales the stored pixels,
+  // losing whatever the old brightness rounded away
+  void setBrightness(uint8_t b)
+  {
+    uint8_t newBrightness = b + 1;
+    if (newBrightness == brightness)
+    {
+      return;
+    }
+
+    uint8_t oldBrightness = brightness - 1;
+    uint16_t scale;
+    if (oldBrightness == 0)
+    {
+      scale = 0;
+    }
+    else if (b == 255)
+    {
+      scale = 65535 / oldBrightness;
+    }
+    else
+    {
+      scale = (((uint16_t)newBrightness << 8) - 1) / oldBrightness;
+    }
+
+    for (uint16_t i = 0; i < numLEDs; i++)
+    {
+      uint32_t c = pixels[i];
+      pixels[i] = Color((((c >> 16) & 0xFF) * scale) >> 8, (((c >> 8) & 0xFF) * scale) >> 8, ((c & 0xFF) * scale) >> 8);
+    }
+    brightness = newBrightness;
+  }
+
+  void setPixelColor(uint16_t n, uint32_t c)
+  {
+    if (n < numLEDs)
+    {
+      uint8_t r = c >> 16;
+      uint8_t g = c >> 8;
+      uint8_t b = c;
+      if (brightness)
+      {
+        r = (r * brightness) >> 8;
+        g = (g * brightness) >> 8;
+        b = (b * brightness) >> 8;
+      }
+      pixels[n] = Color(r, g, b);
+    }
+  }
+
+  void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b)
+  {
+    setPixelColor(n, Color(r, g, b));
+  }
+
+  // Color as set, approximately: the stored value scaled back up
+  uint32_t getPixelColor(uint16_t n) const
+  {
+    if (n >= numLEDs)
+    {
+      return 0;
+    }
+    uint32_t c = pixels[n];
+    if (!brightness)
+    {
+      return c;
+    }
+    return Color((((c >> 16) & 0xFF) << 8) / brightness, (((c >> 8) & 0xFF) << 8) / brightness,
+                 ((c & 0xFF) << 8) / brightness);
+  }
+
+  // Color as show() sends it to the strip
+  uint32_t sentPixelColor(uint16_t n) const
+  {
+    return (n < numLEDs) ? pixels[n] : 0;
+  }
+
+  uint16_t numPixels() const
+  {
+    return numLEDs;
+  }
+
+  uint8_t getBrightness() const
+  {
+    return brightness - 1;
+  }
+
+  static uint32_t Color(uint8_t r, uint8_t g, uint8_t b)
+  {
+    return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+  }
+
+  static uint32_t ColorHSV(uint16_t hue, uint8_t sat = 255, uint8_t val = 255)
+  {
+    uint8_t r, g, b;
+
+    hue = (hue * 1530L + 32768) / 65536;
+    if (hue < 510)
+    {
+      b = 0;
+      if (hue < 255)
+      {
+        r = 255;
+        g = hue;
+      }
+      else
+      {
+        r = 510 - hue;
+        g = 255;
+      }
+    }
+    else if (hue < 1020)
+    {
+      r = 0;
+      if (hue < 765)
+      {
+        g = 255;
+        b = hue - 510;
+      }
+      else
+      {
+        g = 1020 - hue;
+        b = 255;
+      }
+    }
+    else if (hue < 1530)
+    {
+      g = 0;
+      if (hue < 1275)
+      {
+        r = hue - 1020;
+        b = 255;
+      }
+      else
+      {
+        r = 255;
+        b = 1530 - hue;
+      }
+    }
+    else
+    {
+      r = 255;
+      g = b = 0;
+    }
+
+    uint32_t v1 = 1 + val;
+    uint16_t s1 = 1 + sat;
+    uint8_t s2 = 255 - sat;
+    return ((((((r * s1) >> 8) + s2) * v1) & 0xff00) << 8) |
+           (((((g * s1) >> 8) + s2) * v1) & 0xff00) |
+           (((((b * s1) >> 8) + s2) * v1) >> 8);
+  }
+
+  static uint8_t gamma8(uint8_t x)
+  {
+    static uint8_t table[256];
+    static bool ready = false;
+    if (!ready)
+    {
+      for (int i = 0; i < 256; i++)
+      {
+        table[i] = (uint8_t)(pow(i / 255.0, 2.6) * 255.0 + 0.5);
+      }
+      ready = true;
+    }
+    return table[x];
+  }
+
+  static uint32_t gamma32(uint32_t x)
+  {
+    return ((uint32_t)gamma8(x >> 16) << 16) | ((uint32_t)gamma8(x >> 8) << 8) | gamma8(x);
+  }
+
+  unsigned long showCount;      // Number of show() calls so far
+  unsigned long lastShowMicros; // Simulated time of the last show()
+
+private:
+  uint16_t numLEDs;
+  uint8_t brightness;
+  uint32_t *pixels;
+};
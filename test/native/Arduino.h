@@ -0,0 +1,143 @@
+// Minimal Arduino API for the native test environment: a simulated clock,
+// scripted analog/button inputs and a Serial sink. Header-only, because each
+// test suite is a single translation unit that includes src/main.cpp.
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define INPUT_PULLUP 2
+
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+#define A6 20
+#define A7 21
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#undef abs
+#define abs(x) ((x) > 0 ? (x) : -(x))
+
+// Simulated time (microseconds); only the calls below move it forward
+unsigned long simMicros = 0;
+unsigned long simIdleMicros = 0; // Time spent idling in yield()
+
+// Cost of one analogRead() on the Nano (13 ADC clocks at 125 kHz, plus overhead)
+#define SIM_ANALOG_READ_US 112
+
+int simAnalogValue[8] = {512, 512, 512, 512, 512, 512, 512, 512}; // A0..A7
+int simAnalogNoise = 0;                      // Each read adds -noise..+noise
+int (*simAnalogSource)(uint8_t pin) = NULL; // Overrides simAnalogValue when set
+int simButton = HIGH;
+
+unsigned long millis()
+{
+  return simMicros / 1000;
+}
+
+unsigned long micros()
+{
+  return simMicros;
+}
+
+void delay(unsigned long ms)
+{
+  simMicros += ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  simMicros += us;
+}
+
+// Stands in for sleeping until the next timer interrupt (the millis() tick)
+void yield()
+{
+  unsigned long next = (simMicros / 1000 + 1) * 1000;
+  simIdleMicros += next - simMicros;
+  simMicros = next;
+}
+
+int analogRead(uint8_t pin)
+{
+  simMicros += SIM_ANALOG_READ_US;
+  if (simAnalogSource)
+  {
+    return simAnalogSource(pin);
+  }
+
+  int value = simAnalogValue[pin - A0];
+  if (simAnalogNoise)
+  {
+    value += rand() % (2 * simAnalogNoise + 1) - simAnalogNoise;
+  }
+  return constrain(value, 0, 1023);
+}
+
+int digitalRead(uint8_t pin)
+{
+  (void)pin;
+  return simButton;
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  (void)pin;
+  (void)mode;
+}
+
+long random(long howsmall, long howbig)
+{
+  return howsmall + rand() % (howbig - howsmall);
+}
+
+long random(long howbig)
+{
+  return rand() % howbig;
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+// Serial output is discarded
+struct SimSerial
+{
+  void begin(unsigned long baud)
+  {
+    (void)baud;
+  }
+
+  template <typename T>
+  void print(T value)
+  {
+    (void)value;
+  }
+
+  template <typename T>
+  void println(T value)
+  {
+    (void)value;
+  }
+
+  void println()
+  {
+  }
+};
+
+SimSerial Serial;
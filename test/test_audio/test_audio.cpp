@@ -0,0 +1,220 @@
+// Native tests for the sound spectrum analyzer: generated blocks of readings
+// go through analyzeAudio() exactly as captureAudio() would leave them
+#include <unity.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "../../src/main.cpp"
+
+#define SAMPLE_RATE 9615.0 // 16 MHz / 128 prescaler / 13 ADC clocks
+#define BIN_HZ (SAMPLE_RATE / AUDIO_SAMPLES)
+#define MIC_BIAS 512
+
+// Levels are 32 steps per doubling: 128 steps is about 24 dB
+#define MIN_BAND_GAP 128
+
+uint8_t levels[AUDIO_BANDS];
+
+// One block of a sine of `amplitude` ADC counts around the microphone bias
+void generateTone(double hz, double amplitude, double phase)
+{
+  for (uint8_t n = 0; n < AUDIO_SAMPLES; n++)
+  {
+    audioSample(n) = MIC_BIAS + (int)lround(amplitude * sin(2 * M_PI * hz * n / SAMPLE_RATE + phase));
+  }
+}
+
+// One block of constant readings with -noise..+noise of ADC noise
+void generateNoise(int bias, int noise)
+{
+  for (uint8_t n = 0; n < AUDIO_SAMPLES; n++)
+  {
+    audioSample(n) = bias + rand() % (2 * noise + 1) - noise;
+  }
+}
+
+// Frequency in the middle of a band's bins
+double bandCentreHz(uint8_t band)
+{
+  uint8_t first = pgm_read_byte(&AUDIO_BAND_BINS[band]);
+  uint8_t end = pgm_read_byte(&AUDIO_BAND_BINS[band + 1]);
+  return (first + end - 1) / 2.0 * BIN_HZ;
+}
+
+uint8_t loudestBand()
+{
+  uint8_t loudest = 0;
+  for (uint8_t band = 1; band < AUDIO_BANDS; band++)
+  {
+    if (levels[band] > levels[loudest])
+    {
+      loudest = band;
+    }
+  }
+  return loudest;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_band_edges_span_at_least_3_bins(void)
+{
+  for (uint8_t band = 0; band < AUDIO_BANDS; band++)
+  {
+    uint8_t width = pgm_read_byte(&AUDIO_BAND_BINS[band + 1]) - pgm_read_byte(&AUDIO_BAND_BINS[band]);
+    TEST_ASSERT_GREATER_OR_EQUAL(3, width);
+  }
+  TEST_ASSERT_EQUAL(AUDIO_FFT_POINTS, pgm_read_byte(&AUDIO_BAND_BINS[AUDIO_BANDS]));
+}
+
+void test_tones_land_in_their_band(void)
+{
+  const double amplitudes[] = {20, 200, 500};
+
+  for (uint8_t band = 0; band < AUDIO_BANDS; band++)
+  {
+    for (uint8_t a = 0; a < 3; a++)
+    {
+      generateTone(bandCentreHz(band), amplitudes[a], 0.3);
+      analyzeAudio(levels);
+
+      char message[48];
+      snprintf(message, sizeof(message), "band %d, amplitude %.0f", band, amplitudes[a]);
+      TEST_ASSERT_EQUAL_MESSAGE(band, loudestBand(), message);
+      TEST_ASSERT_GREATER_THAN(0, levels[band]);
+    }
+  }
+}
+
+// A tone in the middle of a band must stand well clear of both neighbours,
+// whatever its phase and level
+void test_neighbouring_bands_are_separated(void)
+{
+  for (uint8_t band = 0; band < AUDIO_BANDS; band++)
+  {
+    for (int amplitude = 50; amplitude <= 400; amplitude += 50)
+    {
+      for (uint8_t phase = 0; phase < 16; phase++)
+      {
+        generateTone(bandCentreHz(band), amplitude, phase * M_PI / 8);
+        analyzeAudio(levels);
+
+        if (band > 0)
+        {
+          TEST_ASSERT_GREATER_OR_EQUAL(MIN_BAND_GAP, levels[band] - levels[band - 1]);
+        }
+        if (band < AUDIO_BANDS - 1)
+        {
+          TEST_ASSERT_GREATER_OR_EQUAL(MIN_BAND_GAP, levels[band] - levels[band + 1]);
+        }
+      }
+    }
+  }
+}
+
+// The packed complex FFT plus split must give the spectrum of the 128 real
+// readings: compare every bin with a floating point DFT of the same block
+void test_spectrum_matches_float_dft(void)
+{
+  srand(7);
+  for (uint8_t n = 0; n < AUDIO_SAMPLES; n++)
+  {
+    double t = n / SAMPLE_RATE;
+    audioSample(n) = MIC_BIAS + (int)lround(150 * sin(2 * M_PI * 440 * t) + 80 * sin(2 * M_PI * 2900 * t + 1) +
+                                            rand() % 101 - 50);
+  }
+
+  // Reference: window-weighted bias, same window, scaled like fixFFT()
+  double window[AUDIO_SAMPLES];
+  double weighted = 0;
+  double weights = 0;
+  for (uint8_t n = 0; n < AUDIO_SAMPLES; n++)
+  {
+    window[n] = 0.5 * (1 - cos(2 * M_PI * n / (AUDIO_SAMPLES - 1)));
+    weighted += window[n] * audioSample(n);
+    weights += window[n];
+  }
+  double input[AUDIO_SAMPLES];
+  for (uint8_t n = 0; n < AUDIO_SAMPLES; n++)
+  {
+    input[n] = (audioSample(n) - weighted / weights) * 32 * window[n];
+  }
+
+  analyzeAudio(levels);
+
+  for (uint8_t k = 1; k < AUDIO_FFT_POINTS; k++)
+  {
+    double re = 0;
+    double im = 0;
+    for (uint8_t n = 0; n < AUDIO_SAMPLES; n++)
+    {
+      re += input[n] * cos(2 * M_PI * k * n / AUDIO_SAMPLES);
+      im -= input[n] * sin(2 * M_PI * k * n / AUDIO_SAMPLES);
+    }
+    double expected = sqrt(re * re + im * im) / AUDIO_FFT_POINTS;
+    double actual = sqrt((double)audioSamples[k] * audioSamples[k] + (double)audioImag[k] * audioImag[k]);
+    TEST_ASSERT_INT_WITHIN(8 + expected / 50, (long)expected, (long)actual);
+  }
+}
+
+void test_silence_shows_nothing(void)
+{
+  const int biases[] = {100, 512, 900};
+
+  srand(1);
+  for (uint8_t b = 0; b < 3; b++)
+  {
+    for (uint8_t block = 0; block < 100; block++)
+    {
+      generateNoise(biases[b], 3);
+      analyzeAudio(levels);
+      for (uint8_t band = 0; band < AUDIO_BANDS; band++)
+      {
+        TEST_ASSERT_EQUAL_UINT8(0, levels[band]);
+      }
+    }
+  }
+}
+
+// Host timings only show the relative cost; on the Nano use test_timing
+void test_benchmark_analyze(void)
+{
+  const long frames = 100000;
+  clock_t start = clock();
+  for (long f = 0; f < frames; f++)
+  {
+    generateNoise(MIC_BIAS, 100);
+    analyzeAudio(levels);
+  }
+  clock_t mid = clock();
+  for (long f = 0; f < frames; f++)
+  {
+    generateNoise(MIC_BIAS, 100);
+  }
+  clock_t end = clock();
+
+  double analyze = (double)((mid - start) - (end - mid)) / CLOCKS_PER_SEC;
+  char message[64];
+  snprintf(message, sizeof(message), "analyzeAudio, host ns/frame: %.0f", analyze * 1e9 / frames);
+  TEST_MESSAGE(message);
+}
+
+int main(int argc, char **argv)
+{
+  (void)argc;
+  (void)argv;
+
+  UNITY_BEGIN();
+  RUN_TEST(test_band_edges_span_at_least_3_bins);
+  RUN_TEST(test_tones_land_in_their_band);
+  RUN_TEST(test_neighbouring_bands_are_separated);
+  RUN_TEST(test_spectrum_matches_float_dft);
+  RUN_TEST(test_silence_shows_nothing);
+  RUN_TEST(test_benchmark_analyze);
+  return UNITY_END();
+}
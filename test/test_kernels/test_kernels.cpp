@@ -0,0 +1,278 @@
+// Native tests and benchmark for the compile-time specialised pixel kernels
+#include <unity.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "../../src/main.cpp"
+#include "../legacy/legacy_kernels.h"
+
+// Fire palettes as selected in fireEffect(): inner, middle, outer hue
+const uint16_t FIRE_PALETTES[6][3] = {
+    {0, 4000, 7500},
+    {4000, 7500, 11000},
+    {22000, 33000, 43691},
+    {49500, 54800, 60500},
+    {43691, 33000, 15000},
+    {60500, 0, 4500},
+};
+
+uint32_t snapshot[LED_COUNT];
+
+void takeSnapshot()
+{
+  for (uint16_t i = 0; i < LED_COUNT; i++)
+  {
+    snapshot[i] = strip.getPixelColor(i);
+  }
+}
+
+// Largest difference of any color channel between the snapshot and the strip
+int maxChannelDiff()
+{
+  int worst = 0;
+  for (uint16_t i = 0; i < LED_COUNT; i++)
+  {
+    uint32_t a = snapshot[i];
+    uint32_t b = strip.getPixelColor(i);
+    for (int shift = 0; shift < 24; shift += 8)
+    {
+      int diff = abs((int)((a >> shift) & 0xFF) - (int)((b >> shift) & 0xFF));
+      worst = max(worst, diff);
+    }
+  }
+  return worst;
+}
+
+// Seconds of host CPU time for `frames` calls of fn
+template <typename Fn>
+double timeFrames(Fn fn, long frames)
+{
+  clock_t start = clock();
+  for (long f = 0; f < frames; f++)
+  {
+    fn(f);
+  }
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+void setUp(void)
+{
+  strip.clear();
+}
+
+void tearDown(void)
+{
+}
+
+void test_index_type_is_8_bit_up_to_255_leds(void)
+{
+  TEST_ASSERT_EQUAL(1, sizeof(StripKernel<12>::index_t));
+  TEST_ASSERT_EQUAL(1, sizeof(StripKernel<255>::index_t));
+  TEST_ASSERT_EQUAL(2, sizeof(StripKernel<256>::index_t));
+}
+
+// Third boundaries and Q15 blend factors against the old float positions
+template <uint16_t Count>
+void checkFireGradient()
+{
+  typedef StripKernel<Count> K;
+
+  for (uint16_t i = 0; i < Count; i++)
+  {
+    float position = (float)i / (float)(Count - 1);
+    if (position < 0.33)
+    {
+      TEST_ASSERT_LESS_THAN(K::FIRE_MIDDLE_START, i);
+    }
+    else if (position < 0.66)
+    {
+      TEST_ASSERT_TRUE(i >= K::FIRE_MIDDLE_START && i < K::FIRE_TOP_START);
+      float blend = (position - 0.33) / 0.33;
+      uint32_t q15 = K::FIRE_MIDDLE_BLEND_START + (i - K::FIRE_MIDDLE_START) * K::FIRE_MIDDLE_BLEND_STEP;
+      TEST_ASSERT_INT_WITHIN(100, (long)(blend * 32768), (long)q15);
+    }
+    else
+    {
+      TEST_ASSERT_GREATER_OR_EQUAL(K::FIRE_TOP_START, i);
+      float blend = (position - 0.66) / 0.34;
+      uint32_t q15 = K::FIRE_TOP_BLEND_START + (i - K::FIRE_TOP_START) * K::FIRE_TOP_BLEND_STEP;
+      TEST_ASSERT_INT_WITHIN(100, (long)(blend * 32768), (long)q15);
+      TEST_ASSERT_LESS_OR_EQUAL(32768, q15);
+    }
+  }
+}
+
+void test_fire_gradient_matches_float_positions(void)
+{
+  checkFireGradient<2>();
+  checkFireGradient<3>();
+  checkFireGradient<12>();
+  checkFireGradient<60>();
+  checkFireGradient<144>();
+  checkFireGradient<255>();
+  checkFireGradient<300>();
+}
+
+void test_fire_matches_legacy_loop(void)
+{
+  for (uint8_t palette = 0; palette < 6; palette++)
+  {
+    const uint16_t *hues = FIRE_PALETTES[palette];
+
+    // Same random sequence for both, so only the gradient math differs
+    srand(palette + 1);
+    legacyFire(hues[0], hues[1], hues[2], palette);
+    takeSnapshot();
+
+    srand(palette + 1);
+    Kernel::fire(hues[0], hues[1], hues[2], (palette == 1) ? 93 : 80);
+
+    TEST_ASSERT_LESS_OR_EQUAL(2, maxChannelDiff());
+  }
+}
+
+void fireFrame(long f)
+{
+  const uint16_t *hues = FIRE_PALETTES[f % 6];
+  Kernel::fire(hues[0], hues[1], hues[2], 80);
+}
+
+void legacyFireFrame(long f)
+{
+  const uint16_t *hues = FIRE_PALETTES[f % 6];
+  legacyFire(hues[0], hues[1], hues[2], f % 6);
+}
+
+// Largest channel difference between two packed colors
+int channelDiff(uint32_t a, uint32_t b)
+{
+  int worst = 0;
+  for (int shift = 0; shift < 24; shift += 8)
+  {
+    worst = max(worst, abs((int)((a >> shift) & 0xFF) - (int)((b >> shift) & 0xFF)));
+  }
+  return worst;
+}
+
+uint32_t exactRainbowColor(uint16_t hue)
+{
+  return strip.gamma32(strip.ColorHSV(hue, 255, 255));
+}
+
+void test_rainbow_wheel_matches_hsv_for_every_hue(void)
+{
+  int worst = 0;
+  for (uint32_t hue = 0; hue < 65536; hue++)
+  {
+    worst = max(worst, channelDiff(exactRainbowColor(hue), rainbowWheelColor(hue)));
+  }
+  TEST_ASSERT_LESS_OR_EQUAL(5, worst);
+}
+
+void test_rainbow_matches_legacy_loop(void)
+{
+  for (uint32_t hue = 0; hue < 65536; hue += 127)
+  {
+    legacyRainbow(hue);
+    takeSnapshot();
+    Kernel::rainbow(hue);
+    TEST_ASSERT_LESS_OR_EQUAL(5, maxChannelDiff());
+  }
+}
+
+// rainbowFade() advances the hue by 127 per frame: every frame must move
+void test_rainbow_rotates_every_frame(void)
+{
+  Kernel::rainbow(0);
+  for (uint16_t frame = 1; frame < 1024; frame++)
+  {
+    takeSnapshot();
+    Kernel::rainbow(frame * 127);
+    TEST_ASSERT_GREATER_THAN(0, maxChannelDiff());
+  }
+}
+
+// Equal neighbours on a Count-pixel rainbow starting at red
+template <uint16_t Count, typename ColorFn>
+int equalNeighbours(ColorFn color)
+{
+  int equal = 0;
+  for (uint16_t i = 1; i < Count; i++)
+  {
+    if (color((i - 1) * StripKernel<Count>::HUE_STEP) == color(i * StripKernel<Count>::HUE_STEP))
+    {
+      equal++;
+    }
+  }
+  return equal;
+}
+
+// Above 256 pixels the hue step is smaller than a wheel step; neighbours may
+// only collapse where the gamma curve itself is flat (near the primaries)
+template <uint16_t Count>
+void checkLongStripNeighbours()
+{
+  int exact = equalNeighbours<Count>(exactRainbowColor);
+  int wheel = equalNeighbours<Count>(rainbowWheelColor);
+  TEST_ASSERT_LESS_OR_EQUAL(exact + Count / 50, wheel);
+}
+
+void test_rainbow_neighbours_distinct_on_long_strips(void)
+{
+  checkLongStripNeighbours<300>();
+  checkLongStripNeighbours<600>();
+  checkLongStripNeighbours<1000>();
+}
+
+void rainbowFrame(long f)
+{
+  Kernel::rainbow(f * 127);
+}
+
+void legacyRainbowFrame(long f)
+{
+  legacyRainbow(f * 127);
+}
+
+// Host timings only show the relative cost; on the Nano use test_timing
+void test_benchmark_fire(void)
+{
+  const long frames = 200000;
+  double legacy = timeFrames(legacyFireFrame, frames);
+  double kernel = timeFrames(fireFrame, frames);
+
+  char message[96];
+  snprintf(message, sizeof(message), "fire, host ns/frame: legacy %.0f, kernel %.0f",
+           legacy * 1e9 / frames, kernel * 1e9 / frames);
+  TEST_MESSAGE(message);
+}
+
+void test_benchmark_rainbow(void)
+{
+  const long frames = 200000;
+  double legacy = timeFrames(legacyRainbowFrame, frames);
+  double kernel = timeFrames(rainbowFrame, frames);
+
+  char message[96];
+  snprintf(message, sizeof(message), "rainbow, host ns/frame: legacy %.0f, kernel %.0f",
+           legacy * 1e9 / frames, kernel * 1e9 / frames);
+  TEST_MESSAGE(message);
+}
+
+int main(int argc, char **argv)
+{
+  (void)argc;
+  (void)argv;
+
+  UNITY_BEGIN();
+  RUN_TEST(test_index_type_is_8_bit_up_to_255_leds);
+  RUN_TEST(test_fire_gradient_matches_float_positions);
+  RUN_TEST(test_fire_matches_legacy_loop);
+  RUN_TEST(test_rainbow_wheel_matches_hsv_for_every_hue);
+  RUN_TEST(test_rainbow_matches_legacy_loop);
+  RUN_TEST(test_rainbow_rotates_every_frame);
+  RUN_TEST(test_rainbow_neighbours_distinct_on_long_strips);
+  RUN_TEST(test_benchmark_fire);
+  RUN_TEST(test_benchmark_rainbow);
+  return UNITY_END();
+}
@@ -0,0 +1,208 @@
+// Native tests for the event-driven render loop and the pot input layer,
+// run against the simulated clock and inputs in test/native
+#include <unity.h>
+
+#include "../../src/main.cpp"
+
+#define POT_BRIGHTNESS 0
+#define POT_HUE 1
+#define POT_SPEED 2
+
+// Run loop() for `ms` milliseconds of simulated time
+void runFor(unsigned long ms)
+{
+  unsigned long end = millis() + ms;
+  while ((long)(end - millis()) > 0)
+  {
+    loop();
+  }
+}
+
+// Switch effects directly and let the loop settle on the new one
+void selectEffect(uint8_t effect)
+{
+  currentEffect = effect;
+  runFor(2 * STATIC_REFRESH_MS);
+}
+
+// Poll the inputs often enough for the moving average to settle
+void settlePots()
+{
+  for (int i = 0; i < 100; i++)
+  {
+    pollInputs();
+  }
+}
+
+void setUp(void)
+{
+  simAnalogNoise = 0;
+  simAnalogValue[POT_BRIGHTNESS] = 512;
+  simAnalogValue[POT_HUE] = 512;
+  simAnalogValue[POT_SPEED] = 512;
+  simButton = HIGH;
+}
+
+void tearDown(void)
+{
+}
+
+// Effects 0-2 only change with their inputs: with noisy but idle pots they
+// refresh once per STATIC_REFRESH_MS and the CPU sleeps most of the time
+void test_static_effects_show_about_once_per_second(void)
+{
+  simAnalogNoise = 3;
+
+  for (uint8_t effect = 0; effect <= 2; effect++)
+  {
+    selectEffect(effect);
+
+    unsigned long shows = strip.showCount;
+    unsigned long start = micros();
+    unsigned long idle = simIdleMicros;
+    runFor(10000);
+
+    TEST_ASSERT_UINT32_WITHIN(1, 10, strip.showCount - shows);
+    TEST_ASSERT_GREATER_THAN(90, (simIdleMicros - idle) * 100 / (micros() - start));
+  }
+}
+
+void test_static_effect_redraws_on_input_change(void)
+{
+  selectEffect(2);
+
+  unsigned long shows = strip.showCount;
+  unsigned long start = millis();
+  simAnalogValue[POT_HUE] = 800;
+  while (strip.showCount == shows && millis() - start < STATIC_REFRESH_MS)
+  {
+    loop();
+  }
+
+  TEST_ASSERT_LESS_OR_EQUAL(INPUT_POLL_INTERVAL + 1, millis() - start);
+}
+
+// An animated effect draws its next frame at its deadline: never early, and
+// late by at most one input poll plus the frame itself
+void test_animated_effect_meets_frame_deadline(void)
+{
+  simAnalogNoise = 3;
+  simAnalogValue[POT_SPEED] = 910;
+  selectEffect(4);
+
+  unsigned long speedUs = readSpeedFromPot() * 1000UL;
+  unsigned long shows = strip.showCount;
+  unsigned long lastShow = strip.lastShowMicros;
+  unsigned long shortest = 0xFFFFFFFF;
+  unsigned long longest = 0;
+
+  unsigned long end = millis() + 5000;
+  while ((long)(end - millis()) > 0)
+  {
+    loop();
+    if (strip.showCount != shows)
+    {
+      unsigned long interval = strip.lastShowMicros - lastShow;
+      shortest = min(shortest, interval);
+      longest = max(longest, interval);
+      shows = strip.showCount;
+      lastShow = strip.lastShowMicros;
+    }
+  }
+
+  TEST_ASSERT_UINT32_WITHIN(2, 100, speedUs / 1000);
+  TEST_ASSERT_GREATER_OR_EQUAL(speedUs, shortest);
+  TEST_ASSERT_LESS_OR_EQUAL(speedUs + 3000, longest);
+}
+
+// Press the button until the loop has moved on to the next effect
+void pressButton()
+{
+  uint8_t effect = currentEffect;
+  simButton = LOW;
+  while (currentEffect == effect)
+  {
+    loop();
+  }
+  simButton = HIGH;
+}
+
+// Off leaves the brightness at 0; the first White Light frame must still send
+// the full white, not pixels scaled by the old brightness
+void test_white_light_after_off_is_lit(void)
+{
+  selectEffect(0);
+  pressButton();
+  TEST_ASSERT_EQUAL_UINT8(1, currentEffect);
+
+  uint8_t brightness = readBrightnessFromPot();
+  int warmth = map(huePot.value, POT_MIN, POT_MAX, 0, WARMTH_MAX);
+  uint32_t white = strip.gamma32(whiteFromWarmth(warmth));
+  uint32_t expected = strip.Color((((white >> 16) & 0xFF) * (brightness + 1)) >> 8,
+                                  (((white >> 8) & 0xFF) * (brightness + 1)) >> 8,
+                                  ((white & 0xFF) * (brightness + 1)) >> 8);
+
+  TEST_ASSERT_EQUAL(brightness, strip.getBrightness());
+  for (uint16_t i = 0; i < LED_COUNT; i++)
+  {
+    TEST_ASSERT_EQUAL_HEX32(expected, strip.sentPixelColor(i));
+  }
+}
+
+// Turn the hue pot from mid travel to `raw` and check where it settles
+void checkHueSettles(int raw, uint16_t expected)
+{
+  simAnalogValue[POT_HUE] = 512;
+  settlePots();
+  simAnalogValue[POT_HUE] = raw;
+  settlePots();
+  TEST_ASSERT_EQUAL_UINT16(expected, readHueFromPot());
+}
+
+// The smoothed value must not stall inside the deadband short of the
+// calibrated ends
+void test_pots_reach_calibrated_ends(void)
+{
+  checkHueSettles(POT_MIN, 0);
+  checkHueSettles(POT_MAX, 65535);
+  checkHueSettles(POT_MIN + 1, 0);
+  checkHueSettles(POT_MAX - 1, 65535);
+  checkHueSettles(0, 0);
+
+  simAnalogNoise = 2;
+  simAnalogValue[POT_BRIGHTNESS] = POT_MAX;
+  settlePots();
+  TEST_ASSERT_EQUAL_UINT8(255, readBrightnessFromPot());
+
+  simAnalogValue[POT_BRIGHTNESS] = POT_MIN;
+  settlePots();
+  TEST_ASSERT_EQUAL_UINT8(0, readBrightnessFromPot());
+}
+
+void test_pot_noise_inside_deadband_sends_no_events(void)
+{
+  simAnalogNoise = 3;
+  settlePots();
+
+  for (int i = 0; i < 1000; i++)
+  {
+    TEST_ASSERT_EQUAL_HEX8(0, pollInputs() & (EVENT_BRIGHTNESS | EVENT_HUE | EVENT_SPEED));
+  }
+}
+
+int main(int argc, char **argv)
+{
+  (void)argc;
+  (void)argv;
+
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_static_effects_show_about_once_per_second);
+  RUN_TEST(test_static_effect_redraws_on_input_change);
+  RUN_TEST(test_animated_effect_meets_frame_deadline);
+  RUN_TEST(test_white_light_after_off_is_lit);
+  RUN_TEST(test_pots_reach_calibrated_ends);
+  RUN_TEST(test_pot_noise_inside_deadband_sends_no_events);
+  return UNITY_END();
+}
@@ -0,0 +1,133 @@
+// On-target timing benchmarks (run on the Nano: pio test -e nanoatmega328new).
+// Each test prints the measured microseconds per frame.
+#include <Arduino.h>
+#include <stdio.h>
+#include <unity.h>
+
+#define setup sketchSetup
+#define loop sketchLoop
+#include "../../src/main.cpp"
+#undef setup
+#undef loop
+
+#include "../legacy/legacy_kernels.h"
+
+#define TIMING_FRAMES 100
+
+// Average micros() per call of frame(0..frames-1)
+unsigned long microsPerFrame(void (*frame)(uint16_t), uint16_t frames)
+{
+  unsigned long start = micros();
+  for (uint16_t f = 0; f < frames; f++)
+  {
+    frame(f);
+  }
+  return (micros() - start) / frames;
+}
+
+void reportTiming(const char *name, unsigned long legacy, unsigned long kernel)
+{
+  char message[80];
+  snprintf(message, sizeof(message), "%s us/frame: legacy %lu, kernel %lu", name, legacy, kernel);
+  TEST_MESSAGE(message);
+}
+
+void fireFrame(uint16_t f)
+{
+  Kernel::fire(4000, 7500, 11000 + f, 93);
+}
+
+void legacyFireFrame(uint16_t f)
+{
+  legacyFire(4000, 7500, 11000 + f, 1);
+}
+
+void test_fire_timing(void)
+{
+  unsigned long legacy = microsPerFrame(legacyFireFrame, TIMING_FRAMES);
+  unsigned long kernel = microsPerFrame(fireFrame, TIMING_FRAMES);
+  reportTiming("fire", legacy, kernel);
+  TEST_ASSERT_LESS_OR_EQUAL(legacy, kernel);
+}
+
+void rainbowFrame(uint16_t f)
+{
+  Kernel::rainbow(f * 127);
+}
+
+void legacyRainbowFrame(uint16_t f)
+{
+  legacyRainbow(f * 127);
+}
+
+void test_rainbow_timing(void)
+{
+  unsigned long legacy = microsPerFrame(legacyRainbowFrame, TIMING_FRAMES);
+  unsigned long kernel = microsPerFrame(rainbowFrame, TIMING_FRAMES);
+  reportTiming("rainbow", legacy, kernel);
+  TEST_ASSERT_LESS_OR_EQUAL(legacy, kernel);
+}
+
+uint8_t audioLevels[AUDIO_BANDS];
+
+void captureFrame(uint16_t f)
+{
+  (void)f;
+  captureAudio();
+}
+
+void analyzeFrame(uint16_t f)
+{
+  (void)f;
+  captureAudio();
+  analyzeAudio(audioLevels);
+}
+
+void barsFrame(uint16_t f)
+{
+  Kernel::spectrum(audioLevels, AUDIO_BANDS, f * 256, 43690U / AUDIO_BANDS);
+  strip.show();
+}
+
+// Cost of one Sound Spectrum frame, split into capture, analysis and drawing
+// the bars (including show()); soundSpectrum() then waits AUDIO_FRAME_INTERVAL
+void test_audio_frame_timing(void)
+{
+  unsigned long capture = microsPerFrame(captureFrame, TIMING_FRAMES);
+  unsigned long analyze = microsPerFrame(analyzeFrame, TIMING_FRAMES) - capture;
+  unsigned long bars = microsPerFrame(barsFrame, TIMING_FRAMES);
+
+  char message[96];
+  snprintf(message, sizeof(message), "audio us/frame: capture %lu, analyze %lu, bars %lu, total %lu",
+           capture, analyze, bars, capture + analyze + bars);
+  TEST_MESSAGE(message);
+
+  // The free-running ADC takes 13 clocks at 125 kHz per reading
+  TEST_ASSERT_UINT32_WITHIN(2 * AUDIO_SAMPLE_PERIOD_US, (unsigned long)AUDIO_SAMPLES * AUDIO_SAMPLE_PERIOD_US, capture);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void setup()
+{
+  // Wait for the serial monitor to connect after reset
+  delay(2000);
+
+  strip.begin();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_fire_timing);
+  RUN_TEST(test_rainbow_timing);
+  RUN_TEST(test_audio_frame_timing);
+  UNITY_END();
+}
+
+void loop()
+{
+}
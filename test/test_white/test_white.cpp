@@ -0,0 +1,94 @@
+// Native tests for the color temperature engine (White Light warmth table
+// and the Kelvin conversions)
+#include <unity.h>
+#include <stdio.h>
+
+#include "../../src/main.cpp"
+#include "../legacy/legacy_white.h"
+
+// Largest difference of any color channel between two packed colors
+int channelDiff(uint32_t a, uint32_t b)
+{
+  int worst = 0;
+  for (int shift = 0; shift < 24; shift += 8)
+  {
+    worst = max(worst, abs((int)((a >> shift) & 0xFF) - (int)((b >> shift) & 0xFF)));
+  }
+  return worst;
+}
+
+uint32_t whitePointColor(uint8_t i)
+{
+  return strip.Color(whitePointRead(i, 0), whitePointRead(i, 1), whitePointRead(i, 2));
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_warmth_table_matches_legacy_ladder(void)
+{
+  for (uint16_t warmth = 0; warmth <= WARMTH_MAX; warmth++)
+  {
+    char message[32];
+    snprintf(message, sizeof(message), "warmth %u", warmth);
+    TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(2, channelDiff(legacyWhite(warmth), whiteFromWarmth(warmth)), message);
+  }
+}
+
+void test_warmth_ends_are_the_end_points(void)
+{
+  TEST_ASSERT_EQUAL_HEX32(whitePointColor(0), whiteFromWarmth(0));
+  TEST_ASSERT_EQUAL_HEX32(whitePointColor(WHITE_POINT_COUNT - 1), whiteFromWarmth(WARMTH_MAX));
+  TEST_ASSERT_EQUAL_HEX32(whitePointColor(WHITE_POINT_COUNT - 1), whiteFromWarmth(0xFFFF));
+}
+
+void test_kelvin_of_every_point_is_exact(void)
+{
+  for (uint8_t i = 0; i < WHITE_POINT_COUNT; i++)
+  {
+    uint16_t kelvin = whitePointRead(i, 3);
+    TEST_ASSERT_EQUAL_HEX32(whitePointColor(i), whiteFromKelvin(kelvin));
+    TEST_ASSERT_EQUAL_UINT16(whitePointWarmth(i), kelvinToWarmth(kelvin));
+    TEST_ASSERT_EQUAL_UINT16(kelvin, warmthToKelvin(whitePointWarmth(i)));
+  }
+}
+
+void test_kelvin_outside_calibration_clamps(void)
+{
+  TEST_ASSERT_EQUAL_HEX32(whitePointColor(0), whiteFromKelvin(1000));
+  TEST_ASSERT_EQUAL_HEX32(whitePointColor(WHITE_POINT_COUNT - 1), whiteFromKelvin(20000));
+  TEST_ASSERT_EQUAL_UINT16(0, kelvinToWarmth(0));
+  TEST_ASSERT_EQUAL_UINT16(WARMTH_MAX, kelvinToWarmth(65535));
+}
+
+// Warmth -> Kelvin -> warmth comes back within a step, and Kelvin only rises
+void test_kelvin_round_trip(void)
+{
+  uint16_t previous = 0;
+  for (uint16_t warmth = 0; warmth <= WARMTH_MAX; warmth++)
+  {
+    uint16_t kelvin = warmthToKelvin(warmth);
+    TEST_ASSERT_GREATER_OR_EQUAL(previous, kelvin);
+    TEST_ASSERT_INT_WITHIN(1, warmth, kelvinToWarmth(kelvin));
+    previous = kelvin;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  (void)argc;
+  (void)argv;
+
+  UNITY_BEGIN();
+  RUN_TEST(test_warmth_table_matches_legacy_ladder);
+  RUN_TEST(test_warmth_ends_are_the_end_points);
+  RUN_TEST(test_kelvin_of_every_point_is_exact);
+  RUN_TEST(test_kelvin_outside_calibration_clamps);
+  RUN_TEST(test_kelvin_round_trip);
+  return UNITY_END();
+}